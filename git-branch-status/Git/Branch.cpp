@@ -30,6 +30,7 @@
 #include <stdexcept>
 #include "Branch.hpp"
 #include "Repository.hpp"
+#include "Graph.hpp"
 
 namespace Git
 {
@@ -37,19 +38,19 @@ namespace Git
     {
         public:
             
-            IMPL( git_reference * ref, const Repository & repos );
+            IMPL( const std::string & name, const git_oid & target, bool head, const Repository & repos );
             IMPL( const IMPL & o );
             ~IMPL( void );
             
-            bool graph( size_t & ahead, size_t & behind, const Branch & branch );
+            bool graph( size_t & ahead, size_t & behind, const Branch & self, const Branch & branch );
             
-            git_reference    * _ref;
             const Repository & _repos;
             std::string        _name;
+            git_oid            _target;
             bool               _head;
     };
     
-    Branch::Branch( git_reference * ref, const Repository & repos ): impl( std::make_shared< IMPL >( ref, repos ) )
+    Branch::Branch( const std::string & name, const git_oid & target, bool head, const Repository & repos ): impl( std::make_shared< IMPL >( name, target, head, repos ) )
     {}
     
     Branch::Branch( const Branch & o ): impl( std::make_shared< IMPL >( *( o.impl ) ) )
@@ -65,11 +66,6 @@ namespace Git
         return *( this );
     }
     
-    Branch::operator git_reference *() const
-    {
-        return this->impl->_ref;
-    }
-    
     bool Branch::operator ==( const Branch & o ) const
     {
         return this->impl->_repos == o.impl->_repos && this->impl->_name == o.impl->_name;
@@ -90,7 +86,7 @@ namespace Git
         return this->isBehind( o );
     }
     
-    std::string Branch::name( void ) const
+    const std::string & Branch::name( void ) const
     {
         return this->impl->_name;
     }
@@ -110,7 +106,7 @@ namespace Git
             return false;
         }
         
-        this->impl->graph( ahead, behind, o );
+        this->impl->graph( ahead, behind, *( this ), o );
         
         return ahead > 0;
     }
@@ -125,37 +121,19 @@ namespace Git
             return false;
         }
         
-        this->impl->graph( ahead, behind, o );
+        this->impl->graph( ahead, behind, *( this ), o );
         
         return behind > 0;
     }
     
+    Utility::Optional< git_oid > Branch::target( void ) const
+    {
+        return this->impl->_target;
+    }
+    
     Utility::Optional< Commit > Branch::lastCommit( void ) const
     {
-        const git_oid * oid( nullptr );
-        
-        oid = git_reference_target( this->impl->_ref );
-        
-        if( oid == nullptr )
-        {
-            {
-                git_reference * ref( nullptr );
-                
-                if( git_reference_resolve( &ref, this->impl->_ref ) != 0 || ref == nullptr )
-                {
-                    throw std::runtime_error( "Cannot resolve reference" );
-                }
-                
-                oid = git_reference_target( ref );
-            }
-        }
-        
-        if( oid != nullptr )
-        {
-            return Commit( oid, this->impl->_repos );
-        }
-        
-        return {};
+        return Commit( &( this->impl->_target ), this->impl->_repos );
     }
     
     void swap( Branch & o1, Branch & o2 )
@@ -165,74 +143,73 @@ namespace Git
         swap( o1.impl, o2.impl );
     }
     
-    Branch::IMPL::IMPL( git_reference * ref, const Repository & repos ):
-        _ref( ref ),
+    Branch::IMPL::IMPL( const std::string & name, const git_oid & target, bool head, const Repository & repos ):
         _repos( repos ),
-        _head( false )
+        _name( name ),
+        _head( head )
     {
-        const char * name( nullptr );
-        
-        if( ref == nullptr )
-        {
-            throw std::runtime_error( "Cannot initialize with a NULL git reference" );
-        }
-        
-        if( git_branch_name( &name, ref ) != 0 || name == nullptr )
-        {
-            throw std::runtime_error( "Cannot retrieve branch name" );
-        }
-        
-        this->_name = name;
-        this->_head = git_branch_is_head( ref );
+        git_oid_cpy( &( this->_target ), &target );
     }
     
-    Branch::IMPL::IMPL( const IMPL & o ): IMPL( o._ref, o._repos )
+    Branch::IMPL::IMPL( const IMPL & o ): IMPL( o._name, o._target, o._head, o._repos )
     {}
     
     Branch::IMPL::~IMPL( void )
     {}
     
-    bool Branch::IMPL::graph( size_t & ahead, size_t & behind, const Branch & branch )
+    bool Branch::IMPL::graph( size_t & ahead, size_t & behind, const Branch & self, const Branch & branch )
     {
-        const git_oid * oid1( nullptr );
-        const git_oid * oid2( nullptr );
-        
-        oid1 = git_reference_target( this->_ref );
-        oid2 = git_reference_target( branch.impl->_ref );
-        
-        if( oid1 == nullptr )
+        if( this->_head && branch.isHead() == false )
         {
+            if( this->_repos.aheadBehind( branch, ahead, behind ) )
             {
-                git_reference * ref( nullptr );
-                
-                if( git_reference_resolve( &ref, this->_ref ) != 0 || ref == nullptr )
-                {
-                    throw std::runtime_error( "Cannot resolve reference" );
-                }
-                
-                oid1 = git_reference_target( ref );
+                return true;
+            }
+        }
+        else if( branch.isHead() && this->_head == false )
+        {
+            if( this->_repos.aheadBehind( self, behind, ahead ) )
+            {
+                return true;
             }
         }
         
-        if( oid2 == nullptr )
         {
+            Utility::Optional< git_oid > oid1( self.target() );
+            Utility::Optional< git_oid > oid2( branch.target() );
+            
+            if( oid1.hasValue() == false || oid2.hasValue() == false )
+            {
+                throw std::runtime_error( "Cannot get reference target" );
+            }
+            
             {
-                git_reference * ref( nullptr );
+                Utility::Optional< std::pair< size_t, size_t > > counts( this->_repos.cache().aheadBehind( *( oid1 ), *( oid2 ) ) );
                 
-                if( git_reference_resolve( &ref, branch.impl->_ref ) != 0 || ref == nullptr )
+                if( counts.hasValue() )
                 {
-                    throw std::runtime_error( "Cannot resolve reference" );
+                    ahead  = counts->first;
+                    behind = counts->second;
+                    
+                    return true;
                 }
+            }
+            
+            try
+            {
+                std::pair< size_t, size_t > counts( Graph( this->_repos ).aheadBehind( *( oid1 ), { *( oid2 ) } ).front() );
+                
+                this->_repos.cache().setAheadBehind( *( oid1 ), *( oid2 ), counts );
                 
-                oid2 = git_reference_target( ref );
+                ahead  = counts.first;
+                behind = counts.second;
             }
+            catch( ... )
+            {
+                return false;
+            }
+            
+            return true;
         }
-        
-        if( oid1 == nullptr || oid2 == nullptr )
-        {
-            throw std::runtime_error( "Cannot get reference target" );
-        }
-        
-        return git_graph_ahead_behind( &ahead, &behind, this->_repos, oid1, oid2 ) == 0;
     }
 }
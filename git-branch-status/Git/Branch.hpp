@@ -45,25 +45,24 @@ namespace Git
     {
         public:
             
-            Branch( git_reference * ref, const Repository & repos );
+            Branch( const std::string & name, const git_oid & target, bool head, const Repository & repos );
             Branch( const Branch & o );
             ~Branch( void );
             
             Branch & operator =( Branch o );
             
-            operator git_reference *() const;
-            
             bool operator ==( const Branch & o ) const;
             bool operator !=( const Branch & o ) const;
             
             bool operator >( const Branch & o ) const;
             bool operator <( const Branch & o ) const;
             
-            std::string                 name( void )                 const;
-            bool                        isHead( void )               const;
-            bool                        isAhead( const Branch & o )  const;
-            bool                        isBehind( const Branch & o ) const;
-            Utility::Optional< Commit > lastCommit( void )           const;
+            const std::string          & name( void )                 const;
+            bool                         isHead( void )               const;
+            bool                         isAhead( const Branch & o )  const;
+            bool                         isBehind( const Branch & o ) const;
+            Utility::Optional< git_oid > target( void )               const;
+            Utility::Optional< Commit >  lastCommit( void )           const;
             
             friend void swap( Branch & o1, Branch & o2 );
             
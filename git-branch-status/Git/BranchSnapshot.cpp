@@ -0,0 +1,195 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @file        BranchSnapshot.cpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include <unordered_map>
+#include "BranchSnapshot.hpp"
+
+namespace Git
+{
+    class BranchSnapshot::IMPL
+    {
+        public:
+            
+            static constexpr size_t npos = static_cast< size_t >( -1 );
+            
+            IMPL( const std::vector< BranchStatus > & status );
+            IMPL( const IMPL & o );
+            ~IMPL( void );
+            
+            std::vector< BranchStatus >               _branches;
+            std::unordered_map< std::string, size_t > _index;
+            size_t                                    _head;
+            size_t                                    _longestName;
+            size_t                                    _longestAuthor;
+            bool                                      _saturated;
+    };
+    
+    BranchSnapshot::BranchSnapshot( const std::vector< BranchStatus > & status ): impl( std::make_shared< IMPL >( status ) )
+    {}
+    
+    BranchSnapshot::BranchSnapshot( const BranchSnapshot & o ): impl( std::make_shared< IMPL >( *( o.impl ) ) )
+    {}
+    
+    BranchSnapshot::~BranchSnapshot( void )
+    {}
+    
+    BranchSnapshot & BranchSnapshot::operator =( BranchSnapshot o )
+    {
+        swap( *( this ), o );
+        
+        return *( this );
+    }
+    
+    const std::vector< BranchStatus > & BranchSnapshot::branches( void ) const
+    {
+        return this->impl->_branches;
+    }
+    
+    Utility::Optional< BranchStatus > BranchSnapshot::head( void ) const
+    {
+        if( this->impl->_head == IMPL::npos )
+        {
+            return {};
+        }
+        
+        return this->impl->_branches[ this->impl->_head ];
+    }
+    
+    Utility::Optional< BranchStatus > BranchSnapshot::find( const std::string & name ) const
+    {
+        auto it( this->impl->_index.find( name ) );
+        
+        if( it == this->impl->_index.end() )
+        {
+            return {};
+        }
+        
+        return this->impl->_branches[ it->second ];
+    }
+    
+    size_t BranchSnapshot::longestName( void ) const
+    {
+        return this->impl->_longestName;
+    }
+    
+    size_t BranchSnapshot::longestAuthor( void ) const
+    {
+        return this->impl->_longestAuthor;
+    }
+    
+    bool BranchSnapshot::hasSaturated( void ) const
+    {
+        return this->impl->_saturated;
+    }
+    
+    void swap( BranchSnapshot & o1, BranchSnapshot & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    BranchSnapshot::IMPL::IMPL( const std::vector< BranchStatus > & status ):
+        _branches( status ),
+        _head( npos ),
+        _longestName( 0 ),
+        _longestAuthor( 0 ),
+        _saturated( false )
+    {
+        std::string origin;
+        
+        for( const auto & branch: status )
+        {
+            if( branch.isHead() )
+            {
+                origin = "origin/" + branch.name();
+            }
+        }
+        
+        /* HEAD comes first, followed by its origin branch, then by name */
+        std::sort
+        (
+            std::begin( this->_branches ),
+            std::end( this->_branches ),
+            [ & ]( const BranchStatus & b1, const BranchStatus & b2 )
+            {
+                if( b1.isHead() != b2.isHead() )
+                {
+                    return b1.isHead();
+                }
+                
+                if( ( b1.name() == origin ) != ( b2.name() == origin ) )
+                {
+                    return b1.name() == origin;
+                }
+                
+                return b1.name() < b2.name();
+            }
+        );
+        
+        for( size_t i = 0; i < this->_branches.size(); i++ )
+        {
+            const BranchStatus & branch( this->_branches[ i ] );
+            
+            this->_index[ branch.name() ] = i;
+            
+            if( branch.isHead() )
+            {
+                this->_head = i;
+            }
+            
+            this->_longestName = std::max( this->_longestName, branch.name().size() );
+            this->_saturated   = this->_saturated || branch.isSaturated();
+            
+            if( branch.lastCommit().hasValue() )
+            {
+                if( branch.lastCommit()->authorName().length() > 0 )
+                {
+                    this->_longestAuthor = std::max( this->_longestAuthor, branch.lastCommit()->authorName().size() );
+                }
+                else
+                {
+                    this->_longestAuthor = std::max( this->_longestAuthor, branch.lastCommit()->committerName().size() );
+                }
+            }
+        }
+    }
+    
+    BranchSnapshot::IMPL::IMPL( const IMPL & o ):
+        _branches( o._branches ),
+        _index( o._index ),
+        _head( o._head ),
+        _longestName( o._longestName ),
+        _longestAuthor( o._longestAuthor ),
+        _saturated( o._saturated )
+    {}
+    
+    BranchSnapshot::IMPL::~IMPL( void )
+    {}
+}
@@ -0,0 +1,69 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @header      BranchSnapshot.hpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef GIT_BRANCH_SNAPSHOT_HPP
+#define GIT_BRANCH_SNAPSHOT_HPP
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include "BranchStatus.hpp"
+#include "Optional.hpp"
+
+namespace Git
+{
+    class BranchSnapshot
+    {
+        public:
+            
+            BranchSnapshot( const std::vector< BranchStatus > & status );
+            BranchSnapshot( const BranchSnapshot & o );
+            ~BranchSnapshot( void );
+            
+            BranchSnapshot & operator =( BranchSnapshot o );
+            
+            const std::vector< BranchStatus > & branches( void )                 const;
+            Utility::Optional< BranchStatus >   head( void )                     const;
+            Utility::Optional< BranchStatus >   find( const std::string & name ) const;
+            size_t                              longestName( void )              const;
+            size_t                              longestAuthor( void )            const;
+            bool                                hasSaturated( void )             const;
+            
+            friend void swap( BranchSnapshot & o1, BranchSnapshot & o2 );
+            
+        private:
+            
+            class IMPL;
+            
+            std::shared_ptr< IMPL > impl;
+    };
+}
+
+#endif /* GIT_BRANCH_SNAPSHOT_HPP */
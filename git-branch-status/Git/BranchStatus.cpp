@@ -0,0 +1,138 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @file        BranchStatus.cpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "BranchStatus.hpp"
+
+namespace Git
+{
+    class BranchStatus::IMPL
+    {
+        public:
+            
+            IMPL( const std::string & name, bool head, const Utility::Optional< CommitInfo > & commit, const Utility::Optional< std::pair< size_t, size_t > > & counts, bool saturated, const std::string & upstream, const Utility::Optional< std::pair< size_t, size_t > > & upstreamCounts );
+            ~IMPL( void );
+            
+            std::string                                      _name;
+            bool                                             _head;
+            Utility::Optional< CommitInfo >                  _commit;
+            Utility::Optional< std::pair< size_t, size_t > > _counts;
+            bool                                             _saturated;
+            std::string                                      _upstream;
+            Utility::Optional< std::pair< size_t, size_t > > _upstreamCounts;
+    };
+    
+    BranchStatus::BranchStatus( const std::string & name, bool head, const Utility::Optional< CommitInfo > & commit, const Utility::Optional< std::pair< size_t, size_t > > & counts, bool saturated, const std::string & upstream, const Utility::Optional< std::pair< size_t, size_t > > & upstreamCounts ):
+        impl( std::make_shared< IMPL >( name, head, commit, counts, saturated, upstream, upstreamCounts ) )
+    {}
+    
+    /* Statuses are never modified, so copies share their storage */
+    BranchStatus::BranchStatus( const BranchStatus & o ): impl( o.impl )
+    {}
+    
+    BranchStatus::~BranchStatus( void )
+    {}
+    
+    BranchStatus & BranchStatus::operator =( BranchStatus o )
+    {
+        swap( *( this ), o );
+        
+        return *( this );
+    }
+    
+    const std::string & BranchStatus::name( void ) const
+    {
+        return this->impl->_name;
+    }
+    
+    bool BranchStatus::isHead( void ) const
+    {
+        return this->impl->_head;
+    }
+    
+    Utility::Optional< CommitInfo > BranchStatus::lastCommit( void ) const
+    {
+        return this->impl->_commit;
+    }
+    
+    bool BranchStatus::aheadBehind( size_t & ahead, size_t & behind ) const
+    {
+        if( this->impl->_counts.hasValue() == false )
+        {
+            return false;
+        }
+        
+        ahead  = this->impl->_counts->first;
+        behind = this->impl->_counts->second;
+        
+        return true;
+    }
+    
+    bool BranchStatus::isSaturated( void ) const
+    {
+        return this->impl->_saturated;
+    }
+    
+    const std::string & BranchStatus::upstream( void ) const
+    {
+        return this->impl->_upstream;
+    }
+    
+    bool BranchStatus::upstreamAheadBehind( size_t & ahead, size_t & behind ) const
+    {
+        if( this->impl->_upstreamCounts.hasValue() == false )
+        {
+            return false;
+        }
+        
+        ahead  = this->impl->_upstreamCounts->first;
+        behind = this->impl->_upstreamCounts->second;
+        
+        return true;
+    }
+    
+    void swap( BranchStatus & o1, BranchStatus & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    BranchStatus::IMPL::IMPL( const std::string & name, bool head, const Utility::Optional< CommitInfo > & commit, const Utility::Optional< std::pair< size_t, size_t > > & counts, bool saturated, const std::string & upstream, const Utility::Optional< std::pair< size_t, size_t > > & upstreamCounts ):
+        _name( name ),
+        _head( head ),
+        _commit( commit ),
+        _counts( counts ),
+        _saturated( saturated ),
+        _upstream( upstream ),
+        _upstreamCounts( upstreamCounts )
+    {}
+    
+    BranchStatus::IMPL::~IMPL( void )
+    {}
+}
@@ -0,0 +1,71 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @header      BranchStatus.hpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef GIT_BRANCH_STATUS_HPP
+#define GIT_BRANCH_STATUS_HPP
+
+#include <string>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include <git2.h>
+#include "CommitInfo.hpp"
+#include "Optional.hpp"
+
+namespace Git
+{
+    class BranchStatus
+    {
+        public:
+            
+            BranchStatus( const std::string & name, bool head, const Utility::Optional< CommitInfo > & commit, const Utility::Optional< std::pair< size_t, size_t > > & counts, bool saturated, const std::string & upstream, const Utility::Optional< std::pair< size_t, size_t > > & upstreamCounts );
+            BranchStatus( const BranchStatus & o );
+            ~BranchStatus( void );
+            
+            BranchStatus & operator =( BranchStatus o );
+            
+            const std::string             & name( void )                                           const;
+            bool                            isHead( void )                                         const;
+            Utility::Optional< CommitInfo > lastCommit( void )                                     const;
+            bool                            aheadBehind( size_t & ahead, size_t & behind )         const;
+            bool                            isSaturated( void )                                    const;
+            const std::string             & upstream( void )                                       const;
+            bool                            upstreamAheadBehind( size_t & ahead, size_t & behind ) const;
+            
+            friend void swap( BranchStatus & o1, BranchStatus & o2 );
+            
+        private:
+            
+            class IMPL;
+            
+            std::shared_ptr< IMPL > impl;
+    };
+}
+
+#endif /* GIT_BRANCH_STATUS_HPP */
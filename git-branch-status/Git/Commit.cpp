@@ -28,8 +28,12 @@
  */
 
 #include <stdexcept>
+#include <cstring>
 #include "Commit.hpp"
 #include "Repository.hpp"
+#include "CommitInfo.hpp"
+#include "Handle.hpp"
+#include "OID.hpp"
 
 namespace Git
 {
@@ -41,9 +45,14 @@ namespace Git
             IMPL( const IMPL & o );
             ~IMPL( void );
             
-            const git_oid    * _oid;
-            const Repository & _repos;
-            git_commit       * _commit;
+            git_commit * commit( void );
+            
+            git_oid                         _oid;
+            const Repository              & _repos;
+            Utility::Optional< CommitInfo > _info;
+            CommitHandle                    _commit;
+            git_signature                   _author;
+            git_signature                   _committer;
     };
     
     Commit::Commit( const git_oid * oid, const Repository & repos ): impl( std::make_shared< IMPL >( oid, repos ) )
@@ -64,12 +73,12 @@ namespace Git
     
     Commit::operator git_commit * () const
     {
-        return this->impl->_commit;
+        return this->impl->commit();
     }
     
     Commit::operator const git_oid * () const
     {
-        return this->impl->_oid;
+        return &( this->impl->_oid );
     }
     
     bool Commit::operator ==( const Commit & o ) const
@@ -89,71 +98,41 @@ namespace Git
     
     std::string Commit::hash( size_t length ) const
     {
-        char s[ GIT_OID_HEXSZ + 1 ];
-        
-        if( length == 0 || length > GIT_OID_HEXSZ )
-        {
-            length = GIT_OID_HEXSZ;
-        }
-        
-        memset( s, 0, sizeof( s ) );
-        
-        if( git_oid_tostr( s, sizeof( s ), this->impl->_oid ) == nullptr )
-        {
-            return {};
-        }
-        
-        return std::string( s ).substr( 0, length );
+        return std::string( OIDString( this->impl->_oid, length ).view() );
     }
 
     std::string Commit::body( void ) const
     {
-        const char * s( git_commit_body( this->impl->_commit ) );
+        const char * s( git_commit_body( this->impl->commit() ) );
         
         return ( s == nullptr ) ? "" : s;
     }
     
     std::string Commit::message( void ) const
     {
-        const char * s( git_commit_message( this->impl->_commit ) );
+        const char * s( git_commit_message( this->impl->commit() ) );
         
         return ( s == nullptr ) ? "" : s;
     }
     
-    std::string Commit::summary( void ) const
+    const std::string & Commit::summary( void ) const
     {
-        const char * s( git_commit_summary( this->impl->_commit ) );
-        
-        return ( s == nullptr ) ? "" : s;
+        return this->impl->_info->summary();
     }
     
     time_t Commit::time( void ) const
     {
-        return git_commit_time( this->impl->_commit );
+        return static_cast< time_t >( this->impl->_info->time() );
     }
     
     Utility::Optional< Signature > Commit::author( void ) const
     {
-        const git_signature * s( git_commit_author( this->impl->_commit ) );
-        
-        if( s != nullptr )
-        {
-            return Signature( s, *( this ) );
-        }
-        
-        return {};
+        return Signature( &( this->impl->_author ), *( this ) );
     }
     
     Utility::Optional< Signature > Commit::committer( void ) const
     {
-        const git_signature * s( git_commit_committer( this->impl->_commit ) );
-        
-        if( s != nullptr )
-        {
-            return Signature( s, *( this ) );
-        }
-        
-        return {};
+        return Signature( &( this->impl->_committer ), *( this ) );
     }
     
     void swap( Commit & o1, Commit & o2 )
@@ -164,7 +143,6 @@ namespace Git
     }
     
     Commit::IMPL::IMPL( const git_oid * oid, const Repository & repos ):
-        _oid( oid ),
         _repos( repos )
     {
         if( oid == nullptr )
@@ -172,15 +150,49 @@ namespace Git
             throw std::runtime_error( "Cannot initialize with a NULL git oid" );
         }
         
-        if( git_commit_lookup( &( this->_commit ), repos, oid ) != 0 || this->_commit == nullptr )
+        git_oid_cpy( &( this->_oid ), oid );
+        
+        this->_info = repos.cache().commit( *( oid ) );
+        
+        if( this->_info.hasValue() == false )
         {
-            throw std::runtime_error( "Cannot lookup commit" );
+            this->_info = CommitInfo::read( repos, *( oid ) );
+            
+            if( this->_info.hasValue() == false )
+            {
+                throw std::runtime_error( "Cannot lookup commit" );
+            }
+            
+            repos.cache().setCommit( *( this->_info ) );
         }
+        
+        memset( &( this->_author ),    0, sizeof( git_signature ) );
+        memset( &( this->_committer ), 0, sizeof( git_signature ) );
+        
+        this->_author.name     = const_cast< char * >( this->_info->authorName().c_str() );
+        this->_author.email    = const_cast< char * >( this->_info->authorEmail().c_str() );
+        this->_author.when     = this->_info->authorTime();
+        this->_committer.name  = const_cast< char * >( this->_info->committerName().c_str() );
+        this->_committer.email = const_cast< char * >( this->_info->committerEmail().c_str() );
+        this->_committer.when  = this->_info->committerTime();
     }
     
-    Commit::IMPL::IMPL( const IMPL & o ): IMPL( o._oid, o._repos )
+    Commit::IMPL::IMPL( const IMPL & o ): IMPL( &( o._oid ), o._repos )
     {}
     
     Commit::IMPL::~IMPL( void )
     {}
+    
+    git_commit * Commit::IMPL::commit( void )
+    {
+        if( this->_commit == nullptr )
+        {
+            if( git_commit_lookup( this->_commit.out(), this->_repos, &( this->_oid ) ) != 0 || this->_commit == nullptr )
+            {
+                throw std::runtime_error( "Cannot lookup commit" );
+            }
+        }
+        
+        return this->_commit;
+    }
 }
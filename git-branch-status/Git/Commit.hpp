@@ -61,7 +61,7 @@ namespace Git
             std::string                    hash( size_t length ) const;
             std::string                    body( void )          const;
             std::string                    message( void )       const;
-            std::string                    summary( void )       const;
+            const std::string            & summary( void )       const;
             time_t                         time( void )          const;
             Utility::Optional< Signature > author( void )        const;
             Utility::Optional< Signature > committer( void )     const;
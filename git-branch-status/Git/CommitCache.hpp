@@ -0,0 +1,56 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @header      CommitCache.hpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef GIT_COMMIT_CACHE_HPP
+#define GIT_COMMIT_CACHE_HPP
+
+#include <git2.h>
+#include "LRUCache.hpp"
+#include "CommitInfo.hpp"
+#include "OID.hpp"
+
+namespace Git
+{
+    /*
+     * Commit infos by object id, for all repositories, in memory. As infos
+     * share their storage when copied, a lookup is a hash probe.
+     */
+    class CommitCache: public Utility::LRUCache< git_oid, CommitInfo, OIDHash, OIDEqual >
+    {
+        public:
+            
+            static constexpr size_t capacity = 8192;
+            
+            static CommitCache & shared( void );
+            
+            CommitCache( void );
+    };
+}
+
+#endif /* GIT_COMMIT_CACHE_HPP */
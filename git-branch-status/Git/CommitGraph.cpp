@@ -0,0 +1,476 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @file        CommitGraph.cpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include <stdexcept>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <map>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "CommitGraph.hpp"
+
+/*
+ * Reader for Git's commit-graph files, either a single
+ * objects/info/commit-graph file or an objects/info/commit-graphs chain.
+ * Files are mapped read-only and records are decoded on demand.
+ * Positions are global across a chain, base layers first, as in Git.
+ * A graph is shared by everything reading the same objects directory, and
+ * only read again once Git wrote new files.
+ */
+
+namespace Git
+{
+    class CommitGraph::IMPL
+    {
+        public:
+            
+            class Layer
+            {
+                public:
+                    
+                    Layer( void );
+                    
+                    bool load( const std::string & path, size_t base );
+                    void unload( void );
+                    
+                    const uint8_t * _data;
+                    size_t          _size;
+                    size_t          _base;
+                    size_t          _count;
+                    const uint8_t * _fanout;
+                    const uint8_t * _oids;
+                    const uint8_t * _commits;
+                    const uint8_t * _edges;
+                    size_t          _edgeCount;
+            };
+            
+            static constexpr uint32_t parentNone     = 0x70000000;
+            static constexpr uint32_t parentExtra    = 0x80000000;
+            static constexpr size_t   commitDataSize = GIT_OID_RAWSZ + 16;
+            
+            static uint32_t    read32( const uint8_t * p );
+            static uint64_t    read64( const uint8_t * p );
+            static std::string stamp( const std::string & objectsDirectory );
+            
+            IMPL( const std::string & objectsDirectory );
+            ~IMPL( void );
+            
+            const Layer * layer( size_t position ) const;
+            
+            std::vector< Layer > _layers;
+            size_t               _count;
+    };
+    
+    std::shared_ptr< CommitGraph > CommitGraph::shared( git_repository * repos )
+    {
+        static std::mutex                                                                       * mtx( new std::mutex() );
+        static std::map< std::string, std::pair< std::string, std::shared_ptr< CommitGraph > > > * graphs( new std::map< std::string, std::pair< std::string, std::shared_ptr< CommitGraph > > >() );
+        
+        std::string                   directory( std::string( git_repository_commondir( repos ) ) + "/objects" );
+        std::string                   stamp( IMPL::stamp( directory ) );
+        std::lock_guard< std::mutex > l( *( mtx ) );
+        auto                        & entry( ( *( graphs ) )[ directory ] );
+        
+        /* Git replaces graph files by renaming new ones, so their stats tell when to read them again */
+        if( entry.second == nullptr || entry.first != stamp )
+        {
+            entry.first  = stamp;
+            entry.second = std::make_shared< CommitGraph >( directory );
+        }
+        
+        return entry.second;
+    }
+    
+    CommitGraph::CommitGraph( git_repository * repos ): CommitGraph( std::string( git_repository_commondir( repos ) ) + "/objects" )
+    {}
+    
+    CommitGraph::CommitGraph( const std::string & objectsDirectory ): impl( std::make_shared< IMPL >( objectsDirectory ) )
+    {}
+    
+    CommitGraph::~CommitGraph( void )
+    {}
+    
+    size_t CommitGraph::count( void ) const
+    {
+        return this->impl->_count;
+    }
+    
+    bool CommitGraph::find( const git_oid & oid, size_t & position ) const
+    {
+        for( const auto & layer: this->impl->_layers )
+        {
+            size_t low( ( oid.id[ 0 ] == 0 ) ? 0 : IMPL::read32( layer._fanout + ( oid.id[ 0 ] - 1 ) * 4 ) );
+            size_t high( IMPL::read32( layer._fanout + oid.id[ 0 ] * 4 ) );
+            
+            while( low < high )
+            {
+                size_t middle( low + ( high - low ) / 2 );
+                int    cmp( memcmp( layer._oids + middle * GIT_OID_RAWSZ, oid.id, GIT_OID_RAWSZ ) );
+                
+                if( cmp == 0 )
+                {
+                    position = layer._base + middle;
+                    
+                    return true;
+                }
+                else if( cmp < 0 )
+                {
+                    low = middle + 1;
+                }
+                else
+                {
+                    high = middle;
+                }
+            }
+        }
+        
+        return false;
+    }
+    
+    const git_oid * CommitGraph::oid( size_t position ) const
+    {
+        const IMPL::Layer * layer( this->impl->layer( position ) );
+        
+        if( layer == nullptr )
+        {
+            return nullptr;
+        }
+        
+        return reinterpret_cast< const git_oid * >( layer->_oids + ( position - layer->_base ) * GIT_OID_RAWSZ );
+    }
+    
+    git_time_t CommitGraph::time( size_t position ) const
+    {
+        const IMPL::Layer * layer( this->impl->layer( position ) );
+        
+        if( layer == nullptr )
+        {
+            return 0;
+        }
+        
+        return static_cast< git_time_t >( IMPL::read64( layer->_commits + ( position - layer->_base ) * IMPL::commitDataSize + GIT_OID_RAWSZ + 8 ) & 0x3FFFFFFFF );
+    }
+    
+    uint32_t CommitGraph::generation( size_t position ) const
+    {
+        const IMPL::Layer * layer( this->impl->layer( position ) );
+        uint32_t            generation( 0 );
+        
+        if( layer != nullptr )
+        {
+            generation = IMPL::read32( layer->_commits + ( position - layer->_base ) * IMPL::commitDataSize + GIT_OID_RAWSZ + 8 ) >> 2;
+        }
+        
+        /* Files written without generation numbers store zero */
+        return ( generation == 0 ) ? noGeneration : generation;
+    }
+    
+    void CommitGraph::parents( size_t position, std::vector< size_t > & parents ) const
+    {
+        const IMPL::Layer * layer( this->impl->layer( position ) );
+        
+        parents.clear();
+        
+        if( layer == nullptr )
+        {
+            return;
+        }
+        
+        {
+            const uint8_t * data( layer->_commits + ( position - layer->_base ) * IMPL::commitDataSize + GIT_OID_RAWSZ );
+            uint32_t        parent1( IMPL::read32( data ) );
+            uint32_t        parent2( IMPL::read32( data + 4 ) );
+            
+            if( parent1 == IMPL::parentNone )
+            {
+                return;
+            }
+            
+            parents.push_back( parent1 );
+            
+            if( parent2 == IMPL::parentNone )
+            {
+                return;
+            }
+            
+            if( ( parent2 & IMPL::parentExtra ) == 0 )
+            {
+                parents.push_back( parent2 );
+                
+                return;
+            }
+            
+            for( size_t i = parent2 & ~IMPL::parentExtra; i < layer->_edgeCount; i++ )
+            {
+                uint32_t edge( IMPL::read32( layer->_edges + i * 4 ) );
+                
+                parents.push_back( edge & ~IMPL::parentExtra );
+                
+                if( ( edge & IMPL::parentExtra ) != 0 )
+                {
+                    break;
+                }
+            }
+        }
+    }
+    
+    uint32_t CommitGraph::IMPL::read32( const uint8_t * p )
+    {
+        return ( static_cast< uint32_t >( p[ 0 ] ) << 24 )
+             | ( static_cast< uint32_t >( p[ 1 ] ) << 16 )
+             | ( static_cast< uint32_t >( p[ 2 ] ) <<  8 )
+             |   static_cast< uint32_t >( p[ 3 ] );
+    }
+    
+    uint64_t CommitGraph::IMPL::read64( const uint8_t * p )
+    {
+        return ( static_cast< uint64_t >( read32( p ) ) << 32 ) | read32( p + 4 );
+    }
+    
+    std::string CommitGraph::IMPL::stamp( const std::string & objectsDirectory )
+    {
+        std::string stamp;
+        
+        for( const std::string & path: { objectsDirectory + "/info/commit-graph", objectsDirectory + "/info/commit-graphs/commit-graph-chain" } )
+        {
+            struct stat st;
+            
+            if( stat( path.c_str(), &st ) == 0 )
+            {
+                stamp += std::to_string( st.st_ino ) + ":" + std::to_string( st.st_size ) + ":" + std::to_string( st.st_mtime );
+            }
+            
+            stamp += ";";
+        }
+        
+        return stamp;
+    }
+    
+    CommitGraph::IMPL::IMPL( const std::string & objectsDirectory ):
+        _count( 0 )
+    {
+        std::vector< std::string > paths;
+        
+        {
+            struct stat st;
+            
+            if( stat( ( objectsDirectory + "/info/commit-graph" ).c_str(), &st ) == 0 )
+            {
+                paths.push_back( objectsDirectory + "/info/commit-graph" );
+            }
+            else
+            {
+                std::ifstream chain( objectsDirectory + "/info/commit-graphs/commit-graph-chain" );
+                std::string   hash;
+                
+                while( std::getline( chain, hash ) )
+                {
+                    if( hash.length() > 0 )
+                    {
+                        paths.push_back( objectsDirectory + "/info/commit-graphs/graph-" + hash + ".graph" );
+                    }
+                }
+            }
+        }
+        
+        for( const auto & path: paths )
+        {
+            Layer layer;
+            
+            if( layer.load( path, this->_count ) == false )
+            {
+                /* A broken layer invalidates every layer above it */
+                break;
+            }
+            
+            this->_layers.push_back( layer );
+            
+            this->_count += layer._count;
+        }
+    }
+    
+    CommitGraph::IMPL::~IMPL( void )
+    {
+        for( auto & layer: this->_layers )
+        {
+            layer.unload();
+        }
+    }
+    
+    const CommitGraph::IMPL::Layer * CommitGraph::IMPL::layer( size_t position ) const
+    {
+        for( const auto & layer: this->_layers )
+        {
+            if( position >= layer._base && position < layer._base + layer._count )
+            {
+                return &layer;
+            }
+        }
+        
+        return nullptr;
+    }
+    
+    CommitGraph::IMPL::Layer::Layer( void ):
+        _data( nullptr ),
+        _size( 0 ),
+        _base( 0 ),
+        _count( 0 ),
+        _fanout( nullptr ),
+        _oids( nullptr ),
+        _commits( nullptr ),
+        _edges( nullptr ),
+        _edgeCount( 0 )
+    {}
+    
+    bool CommitGraph::IMPL::Layer::load( const std::string & path, size_t base )
+    {
+        int         fd( open( path.c_str(), O_RDONLY ) );
+        struct stat st;
+        
+        if( fd < 0 )
+        {
+            return false;
+        }
+        
+        if( fstat( fd, &st ) != 0 || st.st_size < 8 )
+        {
+            close( fd );
+            
+            return false;
+        }
+        
+        {
+            void * data( mmap( nullptr, static_cast< size_t >( st.st_size ), PROT_READ, MAP_PRIVATE, fd, 0 ) );
+            
+            close( fd );
+            
+            if( data == MAP_FAILED )
+            {
+                return false;
+            }
+            
+            this->_data = static_cast< const uint8_t * >( data );
+            this->_size = static_cast< size_t >( st.st_size );
+            this->_base = base;
+        }
+        
+        /* Header: signature, version, hash version, chunk count, base graph count */
+        if( memcmp( this->_data, "CGPH", 4 ) != 0 || this->_data[ 4 ] != 1 || this->_data[ 5 ] != 1 )
+        {
+            this->unload();
+            
+            return false;
+        }
+        
+        {
+            size_t chunks( this->_data[ 6 ] );
+            size_t oidsSize( 0 );
+            size_t commitsSize( 0 );
+            
+            if( 8 + ( chunks + 1 ) * 12 > this->_size )
+            {
+                this->unload();
+                
+                return false;
+            }
+            
+            for( size_t i = 0; i < chunks; i++ )
+            {
+                const uint8_t * entry( this->_data + 8 + i * 12 );
+                uint64_t        start( read64( entry + 4 ) );
+                uint64_t        end( read64( entry + 16 ) );
+                
+                if( start > end || end > this->_size )
+                {
+                    this->unload();
+                    
+                    return false;
+                }
+                
+                if( memcmp( entry, "OIDF", 4 ) == 0 && end - start == 256 * 4 )
+                {
+                    this->_fanout = this->_data + start;
+                }
+                else if( memcmp( entry, "OIDL", 4 ) == 0 )
+                {
+                    this->_oids = this->_data + start;
+                    oidsSize    = static_cast< size_t >( end - start );
+                }
+                else if( memcmp( entry, "CDAT", 4 ) == 0 )
+                {
+                    this->_commits = this->_data + start;
+                    commitsSize    = static_cast< size_t >( end - start );
+                }
+                else if( memcmp( entry, "EDGE", 4 ) == 0 )
+                {
+                    this->_edges     = this->_data + start;
+                    this->_edgeCount = static_cast< size_t >( end - start ) / 4;
+                }
+            }
+            
+            if( this->_fanout == nullptr || this->_oids == nullptr || this->_commits == nullptr )
+            {
+                this->unload();
+                
+                return false;
+            }
+            
+            this->_count = read32( this->_fanout + 255 * 4 );
+            
+            if( oidsSize != this->_count * GIT_OID_RAWSZ || commitsSize != this->_count * commitDataSize )
+            {
+                this->unload();
+                
+                return false;
+            }
+        }
+        
+        return true;
+    }
+    
+    void CommitGraph::IMPL::Layer::unload( void )
+    {
+        if( this->_data != nullptr )
+        {
+            munmap( const_cast< uint8_t * >( this->_data ), this->_size );
+        }
+        
+        this->_data      = nullptr;
+        this->_size      = 0;
+        this->_count     = 0;
+        this->_fanout    = nullptr;
+        this->_oids      = nullptr;
+        this->_commits   = nullptr;
+        this->_edges     = nullptr;
+        this->_edgeCount = 0;
+    }
+}
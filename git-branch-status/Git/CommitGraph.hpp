@@ -0,0 +1,71 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @header      CommitGraph.hpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef GIT_COMMIT_GRAPH_HPP
+#define GIT_COMMIT_GRAPH_HPP
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <git2.h>
+
+namespace Git
+{
+    class CommitGraph
+    {
+        public:
+            
+            static constexpr uint32_t noGeneration = 0xFFFFFFFF;
+            
+            static std::shared_ptr< CommitGraph > shared( git_repository * repos );
+            
+            CommitGraph( git_repository * repos );
+            CommitGraph( const std::string & objectsDirectory );
+            CommitGraph( const CommitGraph & o ) = delete;
+            ~CommitGraph( void );
+            
+            CommitGraph & operator =( const CommitGraph & o ) = delete;
+            
+            size_t          count( void )                                               const;
+            bool            find( const git_oid & oid, size_t & position )              const;
+            const git_oid * oid( size_t position )                                      const;
+            git_time_t      time( size_t position )                                     const;
+            uint32_t        generation( size_t position )                               const;
+            void            parents( size_t position, std::vector< size_t > & parents ) const;
+            
+        private:
+            
+            class IMPL;
+            
+            std::shared_ptr< IMPL > impl;
+    };
+}
+
+#endif /* GIT_COMMIT_GRAPH_HPP */
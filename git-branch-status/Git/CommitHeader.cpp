@@ -0,0 +1,341 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @file        CommitHeader.cpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include <cstring>
+#include "CommitHeader.hpp"
+
+/*
+ * Parser for raw commit objects, as read from the object database.
+ * Only the author and committer header lines and the first paragraph of
+ * the message are looked at, in place: other headers, like signatures,
+ * are skipped line by line, and the message body is never scanned.
+ * Signatures and summaries are extracted the same way libgit2 does.
+ */
+
+namespace Git
+{
+    class CommitHeader::IMPL
+    {
+        public:
+            
+            static bool             isSpace( char c );
+            static std::string_view trim( const char * start, const char * end );
+            
+            IMPL( const char * data, size_t size );
+            
+            bool signature( const char * start, const char * end, std::string_view & name, std::string_view & email, git_time & time );
+            
+            bool             _valid;
+            git_time         _authorTime;
+            git_time         _committerTime;
+            std::string_view _authorName;
+            std::string_view _authorEmail;
+            std::string_view _committerName;
+            std::string_view _committerEmail;
+            std::string_view _paragraph;
+    };
+    
+    CommitHeader::CommitHeader( const char * data, size_t size ): impl( std::make_shared< IMPL >( data, size ) )
+    {}
+    
+    CommitHeader::~CommitHeader( void )
+    {}
+    
+    bool CommitHeader::valid( void ) const
+    {
+        return this->impl->_valid;
+    }
+    
+    git_time_t CommitHeader::time( void ) const
+    {
+        return this->impl->_committerTime.time;
+    }
+    
+    const git_time & CommitHeader::authorTime( void ) const
+    {
+        return this->impl->_authorTime;
+    }
+    
+    const git_time & CommitHeader::committerTime( void ) const
+    {
+        return this->impl->_committerTime;
+    }
+    
+    std::string_view CommitHeader::authorName( void ) const
+    {
+        return this->impl->_authorName;
+    }
+    
+    std::string_view CommitHeader::authorEmail( void ) const
+    {
+        return this->impl->_authorEmail;
+    }
+    
+    std::string_view CommitHeader::committerName( void ) const
+    {
+        return this->impl->_committerName;
+    }
+    
+    std::string_view CommitHeader::committerEmail( void ) const
+    {
+        return this->impl->_committerEmail;
+    }
+    
+    std::string_view CommitHeader::paragraph( void ) const
+    {
+        return this->impl->_paragraph;
+    }
+    
+    /* Whitespace runs spanning lines are folded to a single space, as git_commit_summary() does */
+    std::string CommitHeader::summary( void ) const
+    {
+        std::string_view p( this->impl->_paragraph );
+        std::string      summary;
+        size_t           space( std::string_view::npos );
+        bool             newline( false );
+        
+        summary.reserve( p.size() );
+        
+        for( size_t i = 0; i < p.size(); i++ )
+        {
+            if( IMPL::isSpace( p[ i ] ) )
+            {
+                if( space == std::string_view::npos )
+                {
+                    space   = i;
+                    newline = false;
+                }
+                
+                newline |= p[ i ] == '\n';
+            }
+            else
+            {
+                if( space != std::string_view::npos )
+                {
+                    if( newline )
+                    {
+                        summary.push_back( ' ' );
+                    }
+                    else
+                    {
+                        summary.append( p.substr( space, i - space ) );
+                    }
+                    
+                    space = std::string_view::npos;
+                }
+                
+                summary.push_back( p[ i ] );
+            }
+        }
+        
+        return summary;
+    }
+    
+    bool CommitHeader::IMPL::isSpace( char c )
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\f' || c == '\r' || c == '\v';
+    }
+    
+    std::string_view CommitHeader::IMPL::trim( const char * start, const char * end )
+    {
+        while( start < end && IMPL::isSpace( *( start ) ) )
+        {
+            start++;
+        }
+        
+        while( end > start && IMPL::isSpace( *( end - 1 ) ) )
+        {
+            end--;
+        }
+        
+        return std::string_view( start, static_cast< size_t >( end - start ) );
+    }
+    
+    CommitHeader::IMPL::IMPL( const char * data, size_t size ):
+        _valid( false ),
+        _authorTime( { 0, 0, '+' } ),
+        _committerTime( { 0, 0, '+' } )
+    {
+        const char * p( data );
+        const char * end( data + size );
+        bool         author( false );
+        bool         committer( false );
+        
+        if( data == nullptr )
+        {
+            return;
+        }
+        
+        /* Headers end with an empty line */
+        while( p < end )
+        {
+            const char * eol( static_cast< const char * >( memchr( p, '\n', static_cast< size_t >( end - p ) ) ) );
+            
+            if( eol == nullptr )
+            {
+                return;
+            }
+            
+            if( eol == p )
+            {
+                p++;
+                
+                break;
+            }
+            
+            if( author == false && eol - p > 7 && memcmp( p, "author ", 7 ) == 0 )
+            {
+                author = this->signature( p + 7, eol, this->_authorName, this->_authorEmail, this->_authorTime );
+            }
+            else if( committer == false && eol - p > 10 && memcmp( p, "committer ", 10 ) == 0 )
+            {
+                committer = this->signature( p + 10, eol, this->_committerName, this->_committerEmail, this->_committerTime );
+            }
+            
+            p = eol + 1;
+        }
+        
+        if( author == false || committer == false )
+        {
+            return;
+        }
+        
+        /* Like git_commit_message(), leading newlines are not part of the message */
+        while( p < end && *( p ) == '\n' )
+        {
+            p++;
+        }
+        
+        /*
+         * Like git_commit_summary(), the first paragraph only ends with an
+         * empty line, or a newline ending the message: lines made of
+         * whitespace, or of a carriage return, are part of it, and folded
+         * by summary().
+         */
+        {
+            const char * start( p );
+            
+            while( p < end )
+            {
+                const char * eol( static_cast< const char * >( memchr( p, '\n', static_cast< size_t >( end - p ) ) ) );
+                
+                if( eol == nullptr )
+                {
+                    p = end;
+                    
+                    break;
+                }
+                
+                if( eol + 1 == end || *( eol + 1 ) == '\n' )
+                {
+                    p = eol;
+                    
+                    break;
+                }
+                
+                p = eol + 1;
+            }
+            
+            this->_paragraph = std::string_view( start, static_cast< size_t >( p - start ) );
+        }
+        
+        this->_valid = true;
+    }
+    
+    bool CommitHeader::IMPL::signature( const char * start, const char * end, std::string_view & name, std::string_view & email, git_time & time )
+    {
+        const char * emailStart( nullptr );
+        const char * emailEnd( nullptr );
+        
+        for( const char * p = end; p > start; p-- )
+        {
+            if( emailEnd == nullptr && *( p - 1 ) == '>' )
+            {
+                emailEnd = p - 1;
+            }
+            
+            if( emailStart == nullptr && *( p - 1 ) == '<' )
+            {
+                emailStart = p - 1;
+            }
+        }
+        
+        if( emailStart == nullptr || emailEnd == nullptr || emailEnd <= emailStart )
+        {
+            return false;
+        }
+        
+        name  = IMPL::trim( start, emailStart );
+        email = IMPL::trim( emailStart + 1, emailEnd );
+        
+        if( emailEnd + 2 < end )
+        {
+            const char * p( emailEnd + 2 );
+            bool         negative( false );
+            git_time_t   t( 0 );
+            
+            if( p < end && ( *( p ) == '-' || *( p ) == '+' ) )
+            {
+                negative = *( p++ ) == '-';
+            }
+            
+            while( p < end && *( p ) >= '0' && *( p ) <= '9' )
+            {
+                t = ( t * 10 ) + ( *( p++ ) - '0' );
+            }
+            
+            time.time = ( negative ) ? -t : t;
+            
+            /* Timezones are +HHMM or -HHMM, malformed or out of range ones are ignored */
+            if( p + 1 < end && ( p[ 1 ] == '-' || p[ 1 ] == '+' ) )
+            {
+                const char * tz( p + 1 );
+                int          offset( 0 );
+                
+                for( p = tz + 1; p < end && *( p ) >= '0' && *( p ) <= '9' && offset < 10000; p++ )
+                {
+                    offset = ( offset * 10 ) + ( *( p ) - '0' );
+                }
+                
+                if( offset / 100 <= 14 && offset % 100 <= 59 )
+                {
+                    time.offset = ( ( offset / 100 ) * 60 ) + ( offset % 100 );
+                    time.sign   = tz[ 0 ];
+                    
+                    if( tz[ 0 ] == '-' )
+                    {
+                        time.offset = -time.offset;
+                    }
+                }
+            }
+        }
+        
+        return true;
+    }
+}
@@ -0,0 +1,69 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @header      CommitHeader.hpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef GIT_COMMIT_HEADER_HPP
+#define GIT_COMMIT_HEADER_HPP
+
+#include <string>
+#include <string_view>
+#include <memory>
+#include <git2.h>
+
+namespace Git
+{
+    class CommitHeader
+    {
+        public:
+            
+            CommitHeader( const char * data, size_t size );
+            CommitHeader( const CommitHeader & o ) = delete;
+            ~CommitHeader( void );
+            
+            CommitHeader & operator =( const CommitHeader & o ) = delete;
+            
+            bool             valid( void )          const;
+            git_time_t       time( void )           const;
+            const git_time & authorTime( void )     const;
+            const git_time & committerTime( void )  const;
+            std::string_view authorName( void )     const;
+            std::string_view authorEmail( void )    const;
+            std::string_view committerName( void )  const;
+            std::string_view committerEmail( void ) const;
+            std::string_view paragraph( void )      const;
+            std::string      summary( void )        const;
+            
+        private:
+            
+            class IMPL;
+            
+            std::shared_ptr< IMPL > impl;
+    };
+}
+
+#endif /* GIT_COMMIT_HEADER_HPP */
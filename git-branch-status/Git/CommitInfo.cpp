@@ -0,0 +1,227 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @file        CommitInfo.cpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include <stdexcept>
+#include <cstring>
+#include "CommitInfo.hpp"
+#include "CommitHeader.hpp"
+#include "Handle.hpp"
+#include "OID.hpp"
+
+namespace Git
+{
+    class CommitInfo::IMPL
+    {
+        public:
+            
+            IMPL( const git_commit * commit );
+            IMPL( const git_oid & oid, const git_time & authorTime, const git_time & committerTime, const std::string & summary, const std::string & authorName, const std::string & authorEmail, const std::string & committerName, const std::string & committerEmail );
+            ~IMPL( void );
+            
+            git_oid     _oid;
+            git_time    _authorTime;
+            git_time    _committerTime;
+            std::string _summary;
+            std::string _authorName;
+            std::string _authorEmail;
+            std::string _committerName;
+            std::string _committerEmail;
+    };
+    
+    /*
+     * Infos only need a commit's header and first paragraph, so commits are
+     * read raw from the object database and parsed in place, rather than
+     * fully parsed by git_commit_lookup(), which remains the fallback for
+     * objects the raw parser doesn't understand.
+     */
+    Utility::Optional< CommitInfo > CommitInfo::read( git_repository * repos, const git_oid & oid )
+    {
+        ODBHandle       odb;
+        ODBObjectHandle object;
+        
+        if( git_repository_odb( odb.out(), repos ) == 0 && git_odb_read( object.out(), odb, &oid ) == 0 && git_odb_object_type( object ) == GIT_OBJECT_COMMIT )
+        {
+            CommitHeader header( static_cast< const char * >( git_odb_object_data( object ) ), git_odb_object_size( object ) );
+            
+            if( header.valid() )
+            {
+                return CommitInfo( oid, header );
+            }
+        }
+        
+        {
+            CommitHandle commit;
+            
+            if( git_commit_lookup( commit.out(), repos, &oid ) != 0 || commit == nullptr )
+            {
+                return {};
+            }
+            
+            return CommitInfo( commit );
+        }
+    }
+    
+    CommitInfo::CommitInfo( const git_commit * commit ): impl( std::make_shared< IMPL >( commit ) )
+    {}
+    
+    CommitInfo::CommitInfo( const git_oid & oid, const CommitHeader & header ):
+        impl( std::make_shared< IMPL >( oid, header.authorTime(), header.committerTime(), header.summary(), std::string( header.authorName() ), std::string( header.authorEmail() ), std::string( header.committerName() ), std::string( header.committerEmail() ) ) )
+    {}
+    
+    CommitInfo::CommitInfo( const git_oid & oid, const git_time & authorTime, const git_time & committerTime, const std::string & summary, const std::string & authorName, const std::string & authorEmail, const std::string & committerName, const std::string & committerEmail ):
+        impl( std::make_shared< IMPL >( oid, authorTime, committerTime, summary, authorName, authorEmail, committerName, committerEmail ) )
+    {}
+    
+    /* Infos are never modified, so copies share their storage */
+    CommitInfo::CommitInfo( const CommitInfo & o ): impl( o.impl )
+    {}
+    
+    CommitInfo::~CommitInfo( void )
+    {}
+    
+    CommitInfo & CommitInfo::operator =( CommitInfo o )
+    {
+        swap( *( this ), o );
+        
+        return *( this );
+    }
+    
+    const git_oid & CommitInfo::oid( void ) const
+    {
+        return this->impl->_oid;
+    }
+    
+    std::string CommitInfo::hash( void ) const
+    {
+        return this->hash( 0 );
+    }
+    
+    std::string CommitInfo::hash( size_t length ) const
+    {
+        return std::string( OIDString( this->impl->_oid, length ).view() );
+    }
+    
+    git_time_t CommitInfo::time( void ) const
+    {
+        return this->impl->_committerTime.time;
+    }
+    
+    const git_time & CommitInfo::authorTime( void ) const
+    {
+        return this->impl->_authorTime;
+    }
+    
+    const git_time & CommitInfo::committerTime( void ) const
+    {
+        return this->impl->_committerTime;
+    }
+    
+    const std::string & CommitInfo::summary( void ) const
+    {
+        return this->impl->_summary;
+    }
+    
+    const std::string & CommitInfo::authorName( void ) const
+    {
+        return this->impl->_authorName;
+    }
+    
+    const std::string & CommitInfo::authorEmail( void ) const
+    {
+        return this->impl->_authorEmail;
+    }
+    
+    const std::string & CommitInfo::committerName( void ) const
+    {
+        return this->impl->_committerName;
+    }
+    
+    const std::string & CommitInfo::committerEmail( void ) const
+    {
+        return this->impl->_committerEmail;
+    }
+    
+    void swap( CommitInfo & o1, CommitInfo & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    CommitInfo::IMPL::IMPL( const git_commit * commit ):
+        _authorTime( { 0, 0, '+' } ),
+        _committerTime( { 0, 0, '+' } )
+    {
+        if( commit == nullptr )
+        {
+            throw std::runtime_error( "Cannot initialize with a NULL git commit" );
+        }
+        
+        git_oid_cpy( &( this->_oid ), git_commit_id( commit ) );
+        
+        {
+            const char * s( git_commit_summary( const_cast< git_commit * >( commit ) ) );
+            
+            this->_summary = ( s == nullptr ) ? "" : s;
+        }
+        
+        {
+            const git_signature * author( git_commit_author( commit ) );
+            const git_signature * committer( git_commit_committer( commit ) );
+            
+            if( author != nullptr )
+            {
+                this->_authorTime  = author->when;
+                this->_authorName  = ( author->name  == nullptr ) ? "" : author->name;
+                this->_authorEmail = ( author->email == nullptr ) ? "" : author->email;
+            }
+            
+            if( committer != nullptr )
+            {
+                this->_committerTime  = committer->when;
+                this->_committerName  = ( committer->name  == nullptr ) ? "" : committer->name;
+                this->_committerEmail = ( committer->email == nullptr ) ? "" : committer->email;
+            }
+        }
+    }
+    
+    CommitInfo::IMPL::IMPL( const git_oid & oid, const git_time & authorTime, const git_time & committerTime, const std::string & summary, const std::string & authorName, const std::string & authorEmail, const std::string & committerName, const std::string & committerEmail ):
+        _oid( oid ),
+        _authorTime( authorTime ),
+        _committerTime( committerTime ),
+        _summary( summary ),
+        _authorName( authorName ),
+        _authorEmail( authorEmail ),
+        _committerName( committerName ),
+        _committerEmail( committerEmail )
+    {}
+    
+    CommitInfo::IMPL::~IMPL( void )
+    {}
+}
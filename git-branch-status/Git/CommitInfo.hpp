@@ -0,0 +1,79 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @header      CommitInfo.hpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef GIT_COMMIT_INFO_HPP
+#define GIT_COMMIT_INFO_HPP
+
+#include <string>
+#include <memory>
+#include <algorithm>
+#include <git2.h>
+#include "Optional.hpp"
+
+namespace Git
+{
+    class CommitHeader;
+    
+    class CommitInfo
+    {
+        public:
+            
+            static Utility::Optional< CommitInfo > read( git_repository * repos, const git_oid & oid );
+            
+            CommitInfo( const git_commit * commit );
+            CommitInfo( const git_oid & oid, const CommitHeader & header );
+            CommitInfo( const git_oid & oid, const git_time & authorTime, const git_time & committerTime, const std::string & summary, const std::string & authorName, const std::string & authorEmail, const std::string & committerName, const std::string & committerEmail );
+            CommitInfo( const CommitInfo & o );
+            ~CommitInfo( void );
+            
+            CommitInfo & operator =( CommitInfo o );
+            
+            const git_oid     & oid( void )            const;
+            std::string         hash( void )           const;
+            std::string         hash( size_t length )  const;
+            git_time_t          time( void )           const;
+            const git_time    & authorTime( void )     const;
+            const git_time    & committerTime( void )  const;
+            const std::string & summary( void )        const;
+            const std::string & authorName( void )     const;
+            const std::string & authorEmail( void )    const;
+            const std::string & committerName( void )  const;
+            const std::string & committerEmail( void ) const;
+            
+            friend void swap( CommitInfo & o1, CommitInfo & o2 );
+            
+        private:
+            
+            class IMPL;
+            
+            std::shared_ptr< IMPL > impl;
+    };
+}
+
+#endif /* GIT_COMMIT_INFO_HPP */
@@ -0,0 +1,232 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @file        Dashboard.cpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include <ctime>
+#include <algorithm>
+#include <functional>
+#include <map>
+#include "Dashboard.hpp"
+#include "Repository.hpp"
+#include "ThreadPool.hpp"
+
+/*
+ * Only the checked out branch of each repository is evaluated, against its
+ * upstream, so a refresh costs a ref scan, and a walk only when HEAD or its
+ * upstream moved. Repositories only keep their main handle, the mapped
+ * cache and packed-refs, and the packs mapped by libgit2, whose number is
+ * bounded for the whole process.
+ */
+
+namespace Git
+{
+    class Dashboard::IMPL
+    {
+        public:
+            
+            class Entry
+            {
+                public:
+                    
+                    std::string                       _path;
+                    std::unique_ptr< Repository >     _repos;
+                    Utility::Optional< BranchStatus > _head;
+                    std::string                       _error;
+                    time_t                            _changed;
+                    size_t                            _interval;
+                    size_t                            _due;
+            };
+            
+            static constexpr int packFileLimit = 128;
+            
+            IMPL( const std::vector< std::string > & paths, size_t threads );
+            ~IMPL( void );
+            
+            void refresh( Entry & entry );
+            
+            std::vector< Entry > _entries;
+            Utility::ThreadPool  _pool;
+            size_t               _updates;
+    };
+    
+    Dashboard::Dashboard( const std::vector< std::string > & paths, size_t threads ): impl( std::make_shared< IMPL >( paths, threads ) )
+    {}
+    
+    Dashboard::~Dashboard( void )
+    {}
+    
+    size_t Dashboard::count( void ) const
+    {
+        return this->impl->_entries.size();
+    }
+    
+    void Dashboard::setPaths( const std::vector< std::string > & paths )
+    {
+        std::vector< IMPL::Entry >       entries;
+        std::map< std::string, size_t > index;
+        
+        for( size_t i = 0; i < this->impl->_entries.size(); i++ )
+        {
+            index[ this->impl->_entries[ i ]._path ] = i;
+        }
+        
+        /* Repositories which are still monitored are kept open, new ones are refreshed on the next update */
+        for( const auto & path: paths )
+        {
+            auto it( index.find( path ) );
+            
+            if( it != index.end() )
+            {
+                entries.push_back( std::move( this->impl->_entries[ it->second ] ) );
+                index.erase( it );
+            }
+            else
+            {
+                entries.push_back( { path, nullptr, {}, "", 0, 1, this->impl->_updates } );
+            }
+        }
+        
+        this->impl->_entries = std::move( entries );
+    }
+    
+    std::vector< RepositoryStatus > Dashboard::update( void )
+    {
+        std::vector< size_t >                          due;
+        std::vector< std::function< void( size_t ) > > tasks;
+        std::vector< RepositoryStatus >                status;
+        
+        for( size_t i = 0; i < this->impl->_entries.size(); i++ )
+        {
+            if( this->impl->_entries[ i ]._due <= this->impl->_updates )
+            {
+                due.push_back( i );
+            }
+        }
+        
+        /* Recently changed repositories come first, as they are the likeliest to change again */
+        std::sort
+        (
+            std::begin( due ),
+            std::end( due ),
+            [ & ]( size_t i1, size_t i2 )
+            {
+                return this->impl->_entries[ i1 ]._changed > this->impl->_entries[ i2 ]._changed;
+            }
+        );
+        
+        for( size_t i: due )
+        {
+            tasks.push_back( [ this, i ]( size_t ) { this->impl->refresh( this->impl->_entries[ i ] ); } );
+        }
+        
+        this->impl->_pool.run( tasks );
+        this->impl->_updates++;
+        
+        for( const auto & entry: this->impl->_entries )
+        {
+            status.push_back( { entry._path, entry._head, entry._error, entry._changed } );
+        }
+        
+        std::sort
+        (
+            std::begin( status ),
+            std::end( status ),
+            []( const RepositoryStatus & s1, const RepositoryStatus & s2 )
+            {
+                if( s1.attention() != s2.attention() )
+                {
+                    return s1.attention() > s2.attention();
+                }
+                
+                if( s1.changed() != s2.changed() )
+                {
+                    return s1.changed() > s2.changed();
+                }
+                
+                return s1.path() < s2.path();
+            }
+        );
+        
+        return status;
+    }
+    
+    Dashboard::IMPL::IMPL( const std::vector< std::string > & paths, size_t threads ):
+        _pool( threads ),
+        _updates( 0 )
+    {
+        /* Every repository maps its own packs, so their number is capped for all of them */
+        git_libgit2_opts( GIT_OPT_SET_MWINDOW_FILE_LIMIT, packFileLimit );
+        
+        for( const auto & path: paths )
+        {
+            this->_entries.push_back( { path, nullptr, {}, "", 0, 1, 0 } );
+        }
+    }
+    
+    Dashboard::IMPL::~IMPL( void )
+    {}
+    
+    void Dashboard::IMPL::refresh( Entry & entry )
+    {
+        bool changed( false );
+        
+        try
+        {
+            if( entry._repos == nullptr )
+            {
+                entry._repos = std::make_unique< Repository >( entry._path );
+            }
+            else
+            {
+                changed = entry._repos->refresh().isEmpty() == false;
+            }
+            
+            entry._head  = entry._repos->headStatus();
+            entry._error = "";
+        }
+        catch( const std::exception & e )
+        {
+            entry._repos = nullptr;
+            entry._head  = {};
+            entry._error = e.what();
+        }
+        
+        /* Repositories which didn't change are refreshed half as often, up to a bound */
+        if( changed )
+        {
+            entry._changed  = time( nullptr );
+            entry._interval = 1;
+        }
+        else
+        {
+            entry._interval = std::min( entry._interval * 2, maxInterval );
+        }
+        
+        entry._due = this->_updates + entry._interval;
+    }
+}
@@ -0,0 +1,70 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @header      Dashboard.hpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef GIT_DASHBOARD_HPP
+#define GIT_DASHBOARD_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include "RepositoryStatus.hpp"
+
+namespace Git
+{
+    /*
+     * Monitors many repositories at once, each kept open across updates.
+     * Every update refreshes the repositories which are due on a fixed-size
+     * pool; repositories whose refs didn't change are refreshed less and
+     * less often, up to every maxInterval updates.
+     */
+    class Dashboard
+    {
+        public:
+            
+            static constexpr size_t maxInterval = 16;
+            
+            Dashboard( const std::vector< std::string > & paths, size_t threads );
+            Dashboard( const Dashboard & o ) = delete;
+            ~Dashboard( void );
+            
+            Dashboard & operator =( const Dashboard & o ) = delete;
+            
+            size_t                          count( void ) const;
+            void                            setPaths( const std::vector< std::string > & paths );
+            std::vector< RepositoryStatus > update( void );
+            
+        private:
+            
+            class IMPL;
+            
+            std::shared_ptr< IMPL > impl;
+    };
+}
+
+#endif /* GIT_DASHBOARD_HPP */
@@ -0,0 +1,376 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @file        Discovery.cpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
+#include <algorithm>
+#include <functional>
+#include <atomic>
+#include <fnmatch.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "Discovery.hpp"
+#include "ThreadPool.hpp"
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+/*
+ * Each directory is read once. On Linux, entries are read with
+ * getdents64() into a large buffer, so a directory usually takes a single
+ * system call; other systems use readdir(). Entry types come from the
+ * directory itself, and are only stat()ed when the file system doesn't
+ * report them.
+ */
+
+namespace Git
+{
+    class Discovery::IMPL
+    {
+        public:
+            
+            IMPL( const std::vector< std::string > & roots, const std::vector< std::string > & ignores );
+            ~IMPL( void );
+            
+            static constexpr size_t bufferSize = 64 * 1024;
+            
+            bool ignored( const std::string & name ) const;
+            void read( const std::string & directory, std::vector< std::string > & directories, std::vector< std::string > & repositories ) const;
+            void entries( const std::string & directory, const std::function< void( const char * name, unsigned char type ) > & f ) const;
+            
+            std::vector< std::string > _roots;
+            std::vector< std::string > _ignores;
+            std::string                _path;
+            std::atomic< bool >        _stopped;
+    };
+    
+    std::vector< std::string > Discovery::defaultIgnores( void )
+    {
+        return { "node_modules", "bower_components", "vendor", "Pods", "Carthage", "DerivedData", ".build", ".venv", "venv", "__pycache__", ".tox", ".cache", ".Trash" };
+    }
+    
+    Discovery::Discovery( const std::vector< std::string > & roots, const std::vector< std::string > & ignores ): impl( std::make_shared< IMPL >( roots, ignores ) )
+    {}
+    
+    Discovery::~Discovery( void )
+    {}
+    
+    std::vector< std::string > Discovery::cached( void ) const
+    {
+        std::vector< std::string > repositories;
+        std::ifstream              file( this->impl->_path );
+        std::string                line;
+        
+        if( this->impl->_path.length() == 0 || std::getline( file, line ).fail() || line != "GBSD 1" )
+        {
+            return {};
+        }
+        
+        while( std::getline( file, line ) )
+        {
+            if( line.length() > 0 )
+            {
+                repositories.push_back( line );
+            }
+        }
+        
+        return repositories;
+    }
+    
+    std::vector< std::string > Discovery::crawl( void )
+    {
+        std::vector< std::string > level( this->impl->_roots );
+        std::vector< std::string > repositories;
+        
+        while( level.size() > 0 && this->impl->_stopped == false )
+        {
+            Utility::ThreadPool                          & pool( Utility::ThreadPool::shared() );
+            size_t                                         chunks( std::min( pool.count() * 4, level.size() ) );
+            std::vector< std::vector< std::string > >      directories( chunks );
+            std::vector< std::vector< std::string > >      found( chunks );
+            std::vector< std::function< void( size_t ) > > tasks;
+            
+            for( size_t c = 0; c < chunks; c++ )
+            {
+                tasks.push_back
+                (
+                    [ &, c, chunks ]( size_t )
+                    {
+                        for( size_t i = c; i < level.size() && this->impl->_stopped == false; i += chunks )
+                        {
+                            this->impl->read( level[ i ], directories[ c ], found[ c ] );
+                        }
+                    }
+                );
+            }
+            
+            pool.run( tasks );
+            level.clear();
+            
+            for( size_t c = 0; c < chunks; c++ )
+            {
+                level.insert( level.end(), directories[ c ].begin(), directories[ c ].end() );
+                repositories.insert( repositories.end(), found[ c ].begin(), found[ c ].end() );
+            }
+        }
+        
+        std::sort( repositories.begin(), repositories.end() );
+        
+        repositories.erase( std::unique( repositories.begin(), repositories.end() ), repositories.end() );
+        
+        /* The cache is replaced atomically, as other instances may read it, and only by complete crawls */
+        if( this->impl->_path.length() > 0 && this->impl->_stopped == false )
+        {
+            std::string         path( this->impl->_path + ".XXXXXX" );
+            std::string         data( "GBSD 1\n" );
+            std::vector< char > temp( path.begin(), path.end() );
+            int                 fd;
+            
+            for( const auto & repository: repositories )
+            {
+                data += repository + "\n";
+            }
+            
+            /* Each instance writes its own temporary file, like the disk cache, so concurrent crawls never mix */
+            temp.push_back( 0 );
+            
+            fd = mkstemp( temp.data() );
+            
+            if( fd >= 0 )
+            {
+                bool written( fchmod( fd, 0644 ) == 0 && write( fd, data.data(), data.size() ) == static_cast< ssize_t >( data.size() ) );
+                
+                close( fd );
+                
+                if( written == false || rename( temp.data(), this->impl->_path.c_str() ) != 0 )
+                {
+                    unlink( temp.data() );
+                }
+            }
+        }
+        
+        return repositories;
+    }
+    
+    void Discovery::stop( void )
+    {
+        this->impl->_stopped = true;
+    }
+    
+    Discovery::IMPL::IMPL( const std::vector< std::string > & roots, const std::vector< std::string > & ignores ):
+        _ignores( ignores ),
+        _stopped( false )
+    {
+        std::string key;
+        
+        for( const auto & root: roots )
+        {
+            char * path( realpath( root.c_str(), nullptr ) );
+            
+            if( path != nullptr )
+            {
+                this->_roots.push_back( path );
+                free( path );
+            }
+        }
+        
+        std::sort( this->_roots.begin(), this->_roots.end() );
+        
+        for( const auto & root: this->_roots )
+        {
+            key += root + "\n";
+        }
+        
+        for( const auto & ignore: this->_ignores )
+        {
+            key += ignore + "\n";
+        }
+        
+        /* The cache is kept per set of roots and ignore patterns */
+        {
+            const char * cache( getenv( "XDG_CACHE_HOME" ) );
+            const char * home( getenv( "HOME" ) );
+            std::string  directory;
+            char         hash[ 17 ];
+            
+            if( cache != nullptr && cache[ 0 ] != 0 )
+            {
+                directory = cache;
+            }
+            else if( home != nullptr && home[ 0 ] != 0 )
+            {
+                directory = std::string( home ) + "/.cache";
+            }
+            else
+            {
+                return;
+            }
+            
+            mkdir( directory.c_str(), 0755 );
+            
+            directory += "/git-branch-status";
+            
+            mkdir( directory.c_str(), 0755 );
+            snprintf( hash, sizeof( hash ), "%016llx", static_cast< unsigned long long >( std::hash< std::string >()( key ) ) );
+            
+            this->_path = directory + "/discovery-" + hash;
+        }
+    }
+    
+    Discovery::IMPL::~IMPL( void )
+    {}
+    
+    bool Discovery::IMPL::ignored( const std::string & name ) const
+    {
+        for( const auto & pattern: this->_ignores )
+        {
+            if( fnmatch( pattern.c_str(), name.c_str(), 0 ) == 0 )
+            {
+                return true;
+            }
+        }
+        
+        return false;
+    }
+    
+    void Discovery::IMPL::read( const std::string & directory, std::vector< std::string > & directories, std::vector< std::string > & repositories ) const
+    {
+        std::vector< std::string > children;
+        bool                       repository( false );
+        
+        this->entries
+        (
+            directory,
+            [ & ]( const char * name, unsigned char type )
+            {
+                std::string path( directory + "/" + name );
+                
+                if( strcmp( name, "." ) == 0 || strcmp( name, ".." ) == 0 )
+                {
+                    return;
+                }
+                
+                /* A .git file is a worktree or submodule link, and still marks a repository */
+                if( strcmp( name, ".git" ) == 0 )
+                {
+                    repository = true;
+                    
+                    return;
+                }
+                
+                if( type == DT_UNKNOWN )
+                {
+                    struct stat st;
+                    
+                    if( lstat( path.c_str(), &st ) != 0 )
+                    {
+                        return;
+                    }
+                    
+                    type = ( S_ISDIR( st.st_mode ) ) ? DT_DIR : DT_REG;
+                }
+                
+                if( type == DT_DIR && this->ignored( name ) == false )
+                {
+                    children.push_back( path );
+                }
+            }
+        );
+        
+        /* Repositories are not descended into, so nested ones are only found through their parent */
+        if( repository )
+        {
+            repositories.push_back( directory );
+        }
+        else
+        {
+            directories.insert( directories.end(), children.begin(), children.end() );
+        }
+    }
+    
+    void Discovery::IMPL::entries( const std::string & directory, const std::function< void( const char * name, unsigned char type ) > & f ) const
+    {
+        #ifdef __linux__
+        {
+            std::unique_ptr< char[] > buffer( new char[ bufferSize ] );
+            int                       fd( open( directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC ) );
+            
+            if( fd < 0 )
+            {
+                return;
+            }
+            
+            while( true )
+            {
+                long count( syscall( SYS_getdents64, fd, buffer.get(), bufferSize ) );
+                
+                if( count <= 0 )
+                {
+                    break;
+                }
+                
+                /* Records are an inode, an offset, their length, a type, and a null-terminated name */
+                for( long offset = 0; offset < count; )
+                {
+                    const char   * record( buffer.get() + offset );
+                    unsigned short length;
+                    
+                    memcpy( &length, record + 16, sizeof( length ) );
+                    f( record + 19, static_cast< unsigned char >( record[ 18 ] ) );
+                    
+                    offset += length;
+                }
+            }
+            
+            close( fd );
+        }
+        #else
+        {
+            DIR           * dir( opendir( directory.c_str() ) );
+            struct dirent * entry( nullptr );
+            
+            if( dir == nullptr )
+            {
+                return;
+            }
+            
+            while( ( entry = readdir( dir ) ) != nullptr )
+            {
+                f( entry->d_name, entry->d_type );
+            }
+            
+            closedir( dir );
+        }
+        #endif
+    }
+}
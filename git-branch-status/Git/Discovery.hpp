@@ -0,0 +1,71 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @header      Discovery.hpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef GIT_DISCOVERY_HPP
+#define GIT_DISCOVERY_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+
+namespace Git
+{
+    /*
+     * Finds the Git repositories below some directories. Directories are
+     * read in parallel, one tree level at a time, without descending into
+     * repositories, symbolic links, or directories matching an ignore
+     * pattern. The repositories found are cached between runs.
+     * A crawl can be stopped from another thread, in which case it returns
+     * what it found so far, without caching it.
+     */
+    class Discovery
+    {
+        public:
+            
+            static std::vector< std::string > defaultIgnores( void );
+            
+            Discovery( const std::vector< std::string > & roots, const std::vector< std::string > & ignores );
+            Discovery( const Discovery & o ) = delete;
+            ~Discovery( void );
+            
+            Discovery & operator =( const Discovery & o ) = delete;
+            
+            std::vector< std::string > cached( void ) const;
+            std::vector< std::string > crawl( void );
+            void                       stop( void );
+            
+        private:
+            
+            class IMPL;
+            
+            std::shared_ptr< IMPL > impl;
+    };
+}
+
+#endif /* GIT_DISCOVERY_HPP */
@@ -0,0 +1,582 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @file        DiskCache.cpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include <cstring>
+#include <cstdlib>
+#include <mutex>
+#include <map>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "DiskCache.hpp"
+#include "CommitCache.hpp"
+#include "OID.hpp"
+#include "LRUCache.hpp"
+
+/*
+ * Cache file layout, native byte order:
+ * 
+ *  - Header:       magic "GBSC", version, graph count, commit count (uint32)
+ *                  and size of the string pool (uint64).
+ *  - Graph:        base oid, tip oid, ahead, behind (uint64), sorted by
+ *                  base and tip oids.
+ *  - Commits:      oid, committer timezone offset (int32), committer and
+ *                  author times (int64), author timezone offset (int32),
+ *                  committer and author timezone signs (char), padding, and
+ *                  five offset/length pairs (uint32) into the string pool for
+ *                  the summary, author and committer, sorted by oid.
+ *  - String pool.
+ * 
+ * Every entry is keyed by immutable object ids, so entries never need to be
+ * invalidated. The file only keeps the entries used during the last session,
+ * up to a fixed count, the least recently used ones being dropped first.
+ */
+
+namespace Git
+{
+    class DiskCache::IMPL
+    {
+        public:
+            
+            static constexpr uint32_t version          = 3;
+            static constexpr size_t   headerSize       = 24;
+            static constexpr size_t   graphRecordSize  = 56;
+            static constexpr size_t   commitRecordSize = 88;
+            static constexpr size_t   maxGraphs        = 65536;
+            static constexpr size_t   maxCommits       = 16384;
+            
+            IMPL( const std::string & directory );
+            ~IMPL( void );
+            
+            void load( void );
+            void unload( void );
+            
+            const uint8_t * findGraph( const git_oid & base, const git_oid & tip ) const;
+            const uint8_t * findCommit( const git_oid & oid )                      const;
+            
+            std::string string( const uint8_t * record, size_t index ) const;
+            
+            std::string                                                                                                _path;
+            int                                                                                                        _fd;
+            const uint8_t                                                                                            * _data;
+            size_t                                                                                                     _size;
+            uint32_t                                                                                                   _graphCount;
+            uint32_t                                                                                                   _commitCount;
+            const uint8_t                                                                                            * _graphs;
+            const uint8_t                                                                                            * _commits;
+            const uint8_t                                                                                            * _strings;
+            uint64_t                                                                                                   _stringsSize;
+            Utility::LRUCache< std::pair< git_oid, git_oid >, std::pair< size_t, size_t >, OIDPairHash, OIDPairEqual > _touchedGraphs;
+            Utility::LRUCache< git_oid, CommitInfo, OIDHash, OIDEqual >                                                _touchedCommits;
+            bool                                                                                                       _dirty;
+            std::recursive_mutex                                                                                       _mtx;
+    };
+    
+    DiskCache & DiskCache::shared( const std::string & directory )
+    {
+        static std::mutex                          * mtx( new std::mutex() );
+        static std::map< std::string, DiskCache * > * caches( new std::map< std::string, DiskCache * >() );
+        
+        std::lock_guard< std::mutex > l( *( mtx ) );
+        
+        if( caches->count( directory ) == 0 )
+        {
+            ( *( caches ) )[ directory ] = new DiskCache( directory );
+        }
+        
+        return *( ( *( caches ) )[ directory ] );
+    }
+    
+    DiskCache::DiskCache( const std::string & directory ): impl( std::make_shared< IMPL >( directory ) )
+    {}
+    
+    DiskCache::~DiskCache( void )
+    {}
+    
+    std::string DiskCache::path( void ) const
+    {
+        return this->impl->_path;
+    }
+    
+    Utility::Optional< std::pair< size_t, size_t > > DiskCache::aheadBehind( const git_oid & base, const git_oid & tip ) const
+    {
+        std::lock_guard< std::recursive_mutex > l( this->impl->_mtx );
+        
+        {
+            Utility::Optional< std::pair< size_t, size_t > > counts( this->impl->_touchedGraphs.get( { base, tip } ) );
+            
+            if( counts.hasValue() )
+            {
+                return counts;
+            }
+        }
+        
+        {
+            const uint8_t             * record( this->impl->findGraph( base, tip ) );
+            uint64_t                    ahead;
+            uint64_t                    behind;
+            std::pair< size_t, size_t > counts;
+            
+            if( record == nullptr )
+            {
+                return {};
+            }
+            
+            memcpy( &ahead,  record + 2 * GIT_OID_RAWSZ,     sizeof( uint64_t ) );
+            memcpy( &behind, record + 2 * GIT_OID_RAWSZ + 8, sizeof( uint64_t ) );
+            
+            counts = { static_cast< size_t >( ahead ), static_cast< size_t >( behind ) };
+            
+            this->impl->_touchedGraphs.set( { base, tip }, counts );
+            
+            return counts;
+        }
+    }
+    
+    Utility::Optional< CommitInfo > DiskCache::commit( const git_oid & oid ) const
+    {
+        std::lock_guard< std::recursive_mutex > l( this->impl->_mtx );
+        
+        {
+            Utility::Optional< CommitInfo > info( this->impl->_touchedCommits.get( oid ) );
+            
+            if( info.hasValue() )
+            {
+                return info;
+            }
+        }
+        
+        /*
+         * Commits seen by other repositories, like forks or worktrees, are
+         * shared in memory. They still have to be marked as used, so they
+         * are saved with this cache.
+         */
+        {
+            Utility::Optional< CommitInfo > info( CommitCache::shared().get( oid ) );
+            
+            if( info.hasValue() )
+            {
+                this->impl->_touchedCommits.set( oid, *( info ) );
+                
+                this->impl->_dirty = this->impl->_dirty || this->impl->findCommit( oid ) == nullptr;
+                
+                return info;
+            }
+        }
+        
+        {
+            const uint8_t * record( this->impl->findCommit( oid ) );
+            int64_t         times[ 2 ];
+            int32_t         offsets[ 2 ];
+            git_time        committerTime;
+            git_time        authorTime;
+            
+            if( record == nullptr )
+            {
+                return {};
+            }
+            
+            memcpy( &( offsets[ 0 ] ), record + GIT_OID_RAWSZ,      sizeof( int32_t ) );
+            memcpy( times,             record + GIT_OID_RAWSZ + 4,  sizeof( times ) );
+            memcpy( &( offsets[ 1 ] ), record + GIT_OID_RAWSZ + 20, sizeof( int32_t ) );
+            
+            committerTime = { static_cast< git_time_t >( times[ 0 ] ), offsets[ 0 ], static_cast< char >( record[ GIT_OID_RAWSZ + 24 ] ) };
+            authorTime    = { static_cast< git_time_t >( times[ 1 ] ), offsets[ 1 ], static_cast< char >( record[ GIT_OID_RAWSZ + 25 ] ) };
+            
+            {
+                CommitInfo info
+                (
+                    oid,
+                    authorTime,
+                    committerTime,
+                    this->impl->string( record, 0 ),
+                    this->impl->string( record, 1 ),
+                    this->impl->string( record, 2 ),
+                    this->impl->string( record, 3 ),
+                    this->impl->string( record, 4 )
+                );
+                
+                this->impl->_touchedCommits.set( oid, info );
+                CommitCache::shared().set( oid, info );
+                
+                return info;
+            }
+        }
+    }
+    
+    void DiskCache::setAheadBehind( const git_oid & base, const git_oid & tip, const std::pair< size_t, size_t > & counts )
+    {
+        std::lock_guard< std::recursive_mutex > l( this->impl->_mtx );
+        
+        if( this->aheadBehind( base, tip ).hasValue() )
+        {
+            return;
+        }
+        
+        this->impl->_touchedGraphs.set( { base, tip }, counts );
+        
+        this->impl->_dirty = true;
+    }
+    
+    void DiskCache::setCommit( const CommitInfo & info )
+    {
+        std::lock_guard< std::recursive_mutex > l( this->impl->_mtx );
+        
+        if( this->commit( info.oid() ).hasValue() )
+        {
+            return;
+        }
+        
+        this->impl->_touchedCommits.set( info.oid(), info );
+        CommitCache::shared().set( info.oid(), info );
+        
+        this->impl->_dirty = true;
+    }
+    
+    bool DiskCache::save( void )
+    {
+        std::lock_guard< std::recursive_mutex > l( this->impl->_mtx );
+        std::vector< uint8_t >                  data;
+        std::vector< uint8_t >                  strings;
+        std::vector< char >                     temp;
+        
+        if( this->impl->_dirty == false )
+        {
+            return true;
+        }
+        
+        {
+            std::map< std::string, std::pair< size_t, size_t > > graphs;
+            std::map< std::string, CommitInfo >                  commits;
+            uint32_t                                             header[ 4 ];
+            uint64_t                                             stringsSize;
+            
+            this->impl->_touchedGraphs.forEach
+            (
+                [ & ]( const std::pair< git_oid, git_oid > & oids, const std::pair< size_t, size_t > & counts )
+                {
+                    std::string key( reinterpret_cast< const char * >( oids.first.id ), GIT_OID_RAWSZ );
+                    
+                    key.append( reinterpret_cast< const char * >( oids.second.id ), GIT_OID_RAWSZ );
+                    
+                    graphs[ key ] = counts;
+                }
+            );
+            
+            this->impl->_touchedCommits.forEach
+            (
+                [ & ]( const git_oid & oid, const CommitInfo & info )
+                {
+                    commits.insert( { std::string( reinterpret_cast< const char * >( oid.id ), GIT_OID_RAWSZ ), info } );
+                }
+            );
+            
+            memcpy( header, "GBSC", 4 );
+            
+            header[ 1 ] = IMPL::version;
+            header[ 2 ] = static_cast< uint32_t >( graphs.size() );
+            header[ 3 ] = static_cast< uint32_t >( commits.size() );
+            
+            data.insert( data.end(), reinterpret_cast< uint8_t * >( header ), reinterpret_cast< uint8_t * >( header ) + sizeof( header ) );
+            data.resize( IMPL::headerSize );
+            
+            for( const auto & p: graphs )
+            {
+                uint64_t counts[ 2 ] = { p.second.first, p.second.second };
+                
+                data.insert( data.end(), p.first.begin(), p.first.end() );
+                data.insert( data.end(), reinterpret_cast< uint8_t * >( counts ), reinterpret_cast< uint8_t * >( counts ) + sizeof( counts ) );
+            }
+            
+            for( const auto & p: commits )
+            {
+                int32_t             committerOffset( p.second.committerTime().offset );
+                int64_t             times[ 2 ] = { p.second.committerTime().time, p.second.authorTime().time };
+                int32_t             authorOffset( p.second.authorTime().offset );
+                char                signs[ 4 ] = { p.second.committerTime().sign, p.second.authorTime().sign, 0, 0 };
+                const std::string * values[] =
+                {
+                    &( p.second.summary() ),
+                    &( p.second.authorName() ),
+                    &( p.second.authorEmail() ),
+                    &( p.second.committerName() ),
+                    &( p.second.committerEmail() )
+                };
+                
+                data.insert( data.end(), p.first.begin(), p.first.end() );
+                data.insert( data.end(), reinterpret_cast< uint8_t * >( &committerOffset ), reinterpret_cast< uint8_t * >( &committerOffset ) + sizeof( committerOffset ) );
+                data.insert( data.end(), reinterpret_cast< uint8_t * >( times ),            reinterpret_cast< uint8_t * >( times )            + sizeof( times ) );
+                data.insert( data.end(), reinterpret_cast< uint8_t * >( &authorOffset ),    reinterpret_cast< uint8_t * >( &authorOffset )    + sizeof( authorOffset ) );
+                data.insert( data.end(), reinterpret_cast< uint8_t * >( signs ),            reinterpret_cast< uint8_t * >( signs )            + sizeof( signs ) );
+                
+                for( const auto & value: values )
+                {
+                    uint32_t range[ 2 ] = { static_cast< uint32_t >( strings.size() ), static_cast< uint32_t >( value->size() ) };
+                    
+                    data.insert( data.end(), reinterpret_cast< uint8_t * >( range ), reinterpret_cast< uint8_t * >( range ) + sizeof( range ) );
+                    strings.insert( strings.end(), value->begin(), value->end() );
+                }
+            }
+            
+            stringsSize = strings.size();
+            
+            memcpy( data.data() + 16, &stringsSize, sizeof( stringsSize ) );
+            data.insert( data.end(), strings.begin(), strings.end() );
+        }
+        
+        /*
+         * Each save writes its own temporary file, renamed over the cache, so
+         * concurrent instances never share a file, and a file left behind by
+         * a crash never blocks later saves.
+         */
+        {
+            std::string path( this->impl->_path + ".XXXXXX" );
+            int         fd;
+            
+            temp.assign( path.begin(), path.end() );
+            temp.push_back( 0 );
+            
+            fd = mkstemp( temp.data() );
+            
+            if( fd < 0 )
+            {
+                return false;
+            }
+            
+            if( fchmod( fd, 0644 ) != 0 || write( fd, data.data(), data.size() ) != static_cast< ssize_t >( data.size() ) )
+            {
+                close( fd );
+                unlink( temp.data() );
+                
+                return false;
+            }
+            
+            close( fd );
+            
+            if( rename( temp.data(), this->impl->_path.c_str() ) != 0 )
+            {
+                unlink( temp.data() );
+                
+                return false;
+            }
+        }
+        
+        this->impl->_dirty = false;
+        
+        return true;
+    }
+    
+    DiskCache::IMPL::IMPL( const std::string & directory ):
+        _path( directory + "/git-branch-status.cache" ),
+        _fd( -1 ),
+        _data( nullptr ),
+        _size( 0 ),
+        _graphCount( 0 ),
+        _commitCount( 0 ),
+        _graphs( nullptr ),
+        _commits( nullptr ),
+        _strings( nullptr ),
+        _stringsSize( 0 ),
+        _touchedGraphs( maxGraphs ),
+        _touchedCommits( maxCommits ),
+        _dirty( false )
+    {
+        this->load();
+    }
+    
+    DiskCache::IMPL::~IMPL( void )
+    {
+        this->unload();
+    }
+    
+    void DiskCache::IMPL::load( void )
+    {
+        struct stat st;
+        uint32_t    header[ 4 ];
+        
+        this->_fd = open( this->_path.c_str(), O_RDONLY );
+        
+        if( this->_fd < 0 )
+        {
+            return;
+        }
+        
+        if( fstat( this->_fd, &st ) != 0 || static_cast< size_t >( st.st_size ) < headerSize )
+        {
+            this->unload();
+            
+            return;
+        }
+        
+        this->_size = static_cast< size_t >( st.st_size );
+        
+        {
+            void * data( mmap( nullptr, this->_size, PROT_READ, MAP_PRIVATE, this->_fd, 0 ) );
+            
+            if( data == MAP_FAILED )
+            {
+                this->_size = 0;
+                
+                this->unload();
+                
+                return;
+            }
+            
+            this->_data = static_cast< const uint8_t * >( data );
+            
+            /* The mapping outlives the descriptor, so none is kept open per repository */
+            close( this->_fd );
+            
+            this->_fd = -1;
+        }
+        
+        memcpy( header, this->_data, sizeof( header ) );
+        memcpy( &( this->_stringsSize ), this->_data + 16, sizeof( uint64_t ) );
+        
+        if( memcmp( header, "GBSC", 4 ) != 0 || header[ 1 ] != version )
+        {
+            this->unload();
+            
+            return;
+        }
+        
+        this->_graphCount  = header[ 2 ];
+        this->_commitCount = header[ 3 ];
+        
+        if( headerSize + this->_graphCount * graphRecordSize + this->_commitCount * commitRecordSize + this->_stringsSize != this->_size )
+        {
+            this->unload();
+            
+            return;
+        }
+        
+        this->_graphs  = this->_data    + headerSize;
+        this->_commits = this->_graphs  + this->_graphCount  * graphRecordSize;
+        this->_strings = this->_commits + this->_commitCount * commitRecordSize;
+    }
+    
+    void DiskCache::IMPL::unload( void )
+    {
+        if( this->_data != nullptr )
+        {
+            munmap( const_cast< uint8_t * >( this->_data ), this->_size );
+        }
+        
+        if( this->_fd >= 0 )
+        {
+            close( this->_fd );
+        }
+        
+        this->_fd          = -1;
+        this->_data        = nullptr;
+        this->_size        = 0;
+        this->_graphCount  = 0;
+        this->_commitCount = 0;
+        this->_graphs      = nullptr;
+        this->_commits     = nullptr;
+        this->_strings     = nullptr;
+        this->_stringsSize = 0;
+    }
+    
+    const uint8_t * DiskCache::IMPL::findGraph( const git_oid & base, const git_oid & tip ) const
+    {
+        uint8_t key[ 2 * GIT_OID_RAWSZ ];
+        size_t  low( 0 );
+        size_t  high( this->_graphCount );
+        
+        memcpy( key,                 base.id, GIT_OID_RAWSZ );
+        memcpy( key + GIT_OID_RAWSZ, tip.id,  GIT_OID_RAWSZ );
+        
+        while( low < high )
+        {
+            size_t          middle( low + ( high - low ) / 2 );
+            const uint8_t * record( this->_graphs + middle * graphRecordSize );
+            int             cmp( memcmp( record, key, sizeof( key ) ) );
+            
+            if( cmp == 0 )
+            {
+                return record;
+            }
+            else if( cmp < 0 )
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+        
+        return nullptr;
+    }
+    
+    const uint8_t * DiskCache::IMPL::findCommit( const git_oid & oid ) const
+    {
+        size_t low( 0 );
+        size_t high( this->_commitCount );
+        
+        while( low < high )
+        {
+            size_t          middle( low + ( high - low ) / 2 );
+            const uint8_t * record( this->_commits + middle * commitRecordSize );
+            int             cmp( memcmp( record, oid.id, GIT_OID_RAWSZ ) );
+            
+            if( cmp == 0 )
+            {
+                return record;
+            }
+            else if( cmp < 0 )
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+        
+        return nullptr;
+    }
+    
+    std::string DiskCache::IMPL::string( const uint8_t * record, size_t index ) const
+    {
+        uint32_t range[ 2 ];
+        
+        memcpy( range, record + GIT_OID_RAWSZ + 28 + index * sizeof( range ), sizeof( range ) );
+        
+        if( static_cast< uint64_t >( range[ 0 ] ) + range[ 1 ] > this->_stringsSize )
+        {
+            return {};
+        }
+        
+        return std::string( reinterpret_cast< const char * >( this->_strings ) + range[ 0 ], range[ 1 ] );
+    }
+}
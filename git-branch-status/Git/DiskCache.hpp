@@ -0,0 +1,73 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @header      DiskCache.hpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef GIT_DISK_CACHE_HPP
+#define GIT_DISK_CACHE_HPP
+
+#include <string>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include <git2.h>
+#include "CommitInfo.hpp"
+#include "Optional.hpp"
+
+namespace Git
+{
+    class DiskCache
+    {
+        public:
+            
+            static DiskCache & shared( const std::string & directory );
+            
+            DiskCache( const std::string & directory );
+            DiskCache( const DiskCache & o ) = delete;
+            ~DiskCache( void );
+            
+            DiskCache & operator =( const DiskCache & o ) = delete;
+            
+            std::string path( void ) const;
+            
+            Utility::Optional< std::pair< size_t, size_t > > aheadBehind( const git_oid & base, const git_oid & tip ) const;
+            Utility::Optional< CommitInfo >                  commit( const git_oid & oid )                          const;
+            
+            void setAheadBehind( const git_oid & base, const git_oid & tip, const std::pair< size_t, size_t > & counts );
+            void setCommit( const CommitInfo & info );
+            
+            bool save( void );
+            
+        private:
+            
+            class IMPL;
+            
+            std::shared_ptr< IMPL > impl;
+    };
+}
+
+#endif /* GIT_DISK_CACHE_HPP */
@@ -0,0 +1,1059 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @file        Graph.cpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include <stdexcept>
+#include <cstring>
+#include <queue>
+#include <map>
+#include <limits>
+#include <chrono>
+#include <unordered_map>
+#include <unordered_set>
+#include "Graph.hpp"
+#include "CommitGraph.hpp"
+#include "PackBitmap.hpp"
+#include "OID.hpp"
+#include "LRUCache.hpp"
+#include "Handle.hpp"
+
+namespace Git
+{
+    class Graph::IMPL
+    {
+        public:
+            
+            class Node
+            {
+                public:
+                    
+                    git_oid                _oid;
+                    git_time_t             _time;
+                    uint32_t               _generation;
+                    std::vector< git_oid > _parents;
+                    std::vector< size_t >  _positions;
+                    bool                   _queued;
+            };
+            
+            class Entry
+            {
+                public:
+                    
+                    uint32_t   _generation;
+                    git_time_t _time;
+                    size_t     _node;
+            };
+            
+            class Order
+            {
+                public:
+                    
+                    bool operator ()( const Entry & e1, const Entry & e2 ) const
+                    {
+                        if( e1._generation != e2._generation )
+                        {
+                            return e1._generation < e2._generation;
+                        }
+                        
+                        if( e1._time != e2._time )
+                        {
+                            return e1._time < e2._time;
+                        }
+                        
+                        return e1._node > e2._node;
+                    }
+            };
+            
+            class Cache: public Utility::LRUCache< std::pair< git_oid, git_oid >, std::pair< size_t, size_t >, OIDPairHash, OIDPairEqual >
+            {
+                public:
+                    
+                    Cache( void ): LRUCache( 65536 )
+                    {}
+            };
+            
+            static constexpr size_t npos           = static_cast< size_t >( -1 );
+            static constexpr size_t maxBitmapWalk  = 4096;
+            static constexpr size_t maxFastForward = 1024;
+            
+            static Cache & cache( void );
+            
+            IMPL( git_repository * repos, size_t maxCommits, size_t maxMilliseconds );
+            IMPL( const IMPL & o );
+            ~IMPL( void );
+            
+            std::vector< std::pair< size_t, size_t > > aheadBehind( const git_oid & base, const std::vector< git_oid > & tips, std::vector< bool > & saturated );
+            std::vector< std::pair< size_t, size_t > > count( const git_oid & base, const std::vector< git_oid > & tips, std::vector< bool > & saturated );
+            
+            std::vector< std::pair< size_t, size_t > >                pairs( const std::vector< std::pair< git_oid, git_oid > > & pairs );
+            std::vector< std::vector< std::pair< size_t, size_t > > > matrix( const std::vector< git_oid > & tips );
+            
+            bool reachable( const PackBitmap & bitmap, const git_oid & tip, std::vector< uint64_t > & bits, std::unordered_set< git_oid, OIDHash, OIDEqual > & extra );
+            bool parents( const git_oid & oid, std::vector< git_oid > & parents );
+            bool advance( const git_oid & tip, const git_oid & previous, const git_oid & other, size_t & count, size_t & outside );
+            bool revwalk( const std::vector< git_oid > & push, const std::vector< git_oid > & hide, std::vector< git_oid > & commits );
+            
+            void   reset( size_t count );
+            size_t node( const git_oid & oid );
+            size_t node( size_t position );
+            void   mark( size_t n, const uint64_t * bits );
+            void   push( size_t n );
+            bool   full( size_t n ) const;
+            void   walk( void );
+            
+            git_repository                                          * _repos;
+            std::shared_ptr< CommitGraph >                            _commitGraph;
+            size_t                                                    _words;
+            std::vector< uint64_t >                                   _full;
+            std::vector< uint64_t >                                   _bits;
+            std::vector< Node >                                       _nodes;
+            std::unordered_map< git_oid, size_t, OIDHash, OIDEqual >  _index;
+            std::unordered_map< size_t, size_t >                      _positions;
+            std::priority_queue< Entry, std::vector< Entry >, Order > _queue;
+            size_t                                                    _pending;
+            size_t                                                    _maxCommits;
+            size_t                                                    _maxTime;
+            bool                                                      _stopped;
+    };
+    
+    Graph::Graph( git_repository * repos ): impl( std::make_shared< IMPL >( repos, 0, 0 ) )
+    {}
+    
+    Graph::Graph( git_repository * repos, size_t maxCommits, size_t maxMilliseconds ): impl( std::make_shared< IMPL >( repos, maxCommits, maxMilliseconds ) )
+    {}
+    
+    Graph::Graph( const Graph & o ): impl( std::make_shared< IMPL >( *( o.impl ) ) )
+    {}
+    
+    Graph::~Graph( void )
+    {}
+    
+    Graph & Graph::operator =( Graph o )
+    {
+        swap( *( this ), o );
+        
+        return *( this );
+    }
+    
+    std::vector< std::pair< size_t, size_t > > Graph::aheadBehind( const git_oid & base, const std::vector< git_oid > & tips ) const
+    {
+        std::vector< bool > saturated;
+        
+        return this->aheadBehind( base, tips, saturated );
+    }
+    
+    std::vector< std::pair< size_t, size_t > > Graph::aheadBehind( const git_oid & base, const std::vector< git_oid > & tips, std::vector< bool > & saturated ) const
+    {
+        std::vector< std::pair< size_t, size_t > > counts( tips.size(), { 0, 0 } );
+        std::vector< git_oid >                     missing;
+        std::vector< size_t >                      indices;
+        
+        saturated.assign( tips.size(), false );
+        
+        for( size_t i = 0; i < tips.size(); i++ )
+        {
+            Utility::Optional< std::pair< size_t, size_t > > cached( IMPL::cache().get( { base, tips[ i ] } ) );
+            
+            if( cached.hasValue() )
+            {
+                counts[ i ] = *( cached );
+            }
+            else if( OIDEqual()( base, tips[ i ] ) == false )
+            {
+                missing.push_back( tips[ i ] );
+                indices.push_back( i );
+            }
+        }
+        
+        if( missing.size() > 0 )
+        {
+            std::vector< bool >                        stopped;
+            std::vector< std::pair< size_t, size_t > > computed( this->impl->aheadBehind( base, missing, stopped ) );
+            
+            for( size_t i = 0; i < missing.size(); i++ )
+            {
+                counts[ indices[ i ] ]    = computed[ i ];
+                saturated[ indices[ i ] ] = stopped[ i ];
+                
+                if( stopped[ i ] )
+                {
+                    continue;
+                }
+                
+                IMPL::cache().set( { base, missing[ i ] }, computed[ i ] );
+            }
+        }
+        
+        return counts;
+    }
+    
+    std::vector< std::pair< size_t, size_t > > Graph::aheadBehind( const std::vector< std::pair< git_oid, git_oid > > & pairs ) const
+    {
+        std::vector< std::pair< size_t, size_t > >   counts( pairs.size(), { 0, 0 } );
+        std::vector< std::pair< git_oid, git_oid > > missing;
+        std::vector< size_t >                        indices;
+        
+        for( size_t i = 0; i < pairs.size(); i++ )
+        {
+            Utility::Optional< std::pair< size_t, size_t > > cached( IMPL::cache().get( pairs[ i ] ) );
+            
+            if( cached.hasValue() )
+            {
+                counts[ i ] = *( cached );
+            }
+            else if( OIDEqual()( pairs[ i ].first, pairs[ i ].second ) == false )
+            {
+                missing.push_back( pairs[ i ] );
+                indices.push_back( i );
+            }
+        }
+        
+        if( missing.size() > 0 )
+        {
+            std::vector< std::pair< size_t, size_t > > computed( this->impl->pairs( missing ) );
+            
+            for( size_t i = 0; i < missing.size(); i++ )
+            {
+                counts[ indices[ i ] ] = computed[ i ];
+                
+                IMPL::cache().set( missing[ i ], computed[ i ] );
+            }
+        }
+        
+        return counts;
+    }
+    
+    std::vector< std::vector< std::pair< size_t, size_t > > > Graph::matrix( const std::vector< git_oid > & tips ) const
+    {
+        return this->impl->matrix( tips );
+    }
+    
+    Utility::Optional< std::pair< size_t, size_t > > Graph::fastForward( const git_oid & base, const git_oid & tip, const git_oid & previousBase, const git_oid & previousTip, const std::pair< size_t, size_t > & counts ) const
+    {
+        std::pair< size_t, size_t > updated( counts );
+        size_t                      count( 0 );
+        size_t                      outside( 0 );
+        
+        /*
+         * New tip commits not reachable from the base are added to the behind
+         * count, and those reachable from it are removed from the ahead count.
+         * The base is then advanced the same way against the new tip.
+         */
+        if( this->impl->advance( tip, previousTip, previousBase, count, outside ) == false || updated.first < count - outside )
+        {
+            return {};
+        }
+        
+        updated.first  -= count - outside;
+        updated.second += outside;
+        
+        if( this->impl->advance( base, previousBase, tip, count, outside ) == false || updated.second < count - outside )
+        {
+            return {};
+        }
+        
+        updated.first  += outside;
+        updated.second -= count - outside;
+        
+        IMPL::cache().set( { base, tip }, updated );
+        
+        return updated;
+    }
+    
+    void swap( Graph & o1, Graph & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    Graph::IMPL::Cache & Graph::IMPL::cache( void )
+    {
+        static Cache * cache( new Cache() );
+        
+        return *( cache );
+    }
+    
+    Graph::IMPL::IMPL( git_repository * repos, size_t maxCommits, size_t maxMilliseconds ):
+        _repos( repos ),
+        _commitGraph( CommitGraph::shared( repos ) ),
+        _words( 0 ),
+        _pending( 0 ),
+        _maxCommits( maxCommits ),
+        _maxTime( maxMilliseconds ),
+        _stopped( false )
+    {}
+    
+    Graph::IMPL::IMPL( const IMPL & o ): IMPL( o._repos, o._maxCommits, o._maxTime )
+    {}
+    
+    Graph::IMPL::~IMPL( void )
+    {}
+    
+    std::vector< std::pair< size_t, size_t > > Graph::IMPL::aheadBehind( const git_oid & base, const std::vector< git_oid > & tips, std::vector< bool > & saturated )
+    {
+        std::vector< std::pair< size_t, size_t > >       counts( tips.size(), { 0, 0 } );
+        std::vector< git_oid >                           missing;
+        std::vector< size_t >                            indices;
+        std::shared_ptr< PackBitmap >                    bitmap( PackBitmap::shared( this->_repos ) );
+        std::vector< uint64_t >                          baseBits;
+        std::unordered_set< git_oid, OIDHash, OIDEqual > baseExtra;
+        
+        saturated.assign( tips.size(), false );
+        
+        /*
+         * With a reachability bitmap, counts are popcounts of the difference
+         * between the tips' bitmaps. Commits not covered by the bitmap are
+         * walked until a bitmapped commit is reached. Tips too far from any
+         * bitmapped commit are counted by the regular walk.
+         */
+        if( bitmap->count() > 0 && this->reachable( *( bitmap ), base, baseBits, baseExtra ) )
+        {
+            for( size_t i = 0; i < tips.size(); i++ )
+            {
+                std::vector< uint64_t >                          bits;
+                std::unordered_set< git_oid, OIDHash, OIDEqual > extra;
+                
+                if( this->reachable( *( bitmap ), tips[ i ], bits, extra ) == false )
+                {
+                    missing.push_back( tips[ i ] );
+                    indices.push_back( i );
+                    
+                    continue;
+                }
+                
+                counts[ i ].first  = bitmap->difference( baseBits, bits );
+                counts[ i ].second = bitmap->difference( bits, baseBits );
+                
+                for( const auto & oid: baseExtra )
+                {
+                    if( extra.count( oid ) == 0 )
+                    {
+                        counts[ i ].first++;
+                    }
+                }
+                
+                for( const auto & oid: extra )
+                {
+                    if( baseExtra.count( oid ) == 0 )
+                    {
+                        counts[ i ].second++;
+                    }
+                }
+            }
+        }
+        else
+        {
+            missing = tips;
+            
+            for( size_t i = 0; i < tips.size(); i++ )
+            {
+                indices.push_back( i );
+            }
+        }
+        
+        if( missing.size() > 0 )
+        {
+            std::vector< bool >                        stopped;
+            std::vector< std::pair< size_t, size_t > > computed( this->count( base, missing, stopped ) );
+            
+            for( size_t i = 0; i < missing.size(); i++ )
+            {
+                counts[ indices[ i ] ]    = computed[ i ];
+                saturated[ indices[ i ] ] = stopped[ i ];
+            }
+        }
+        
+        return counts;
+    }
+    
+    std::vector< std::pair< size_t, size_t > > Graph::IMPL::count( const git_oid & base, const std::vector< git_oid > & tips, std::vector< bool > & saturated )
+    {
+        std::vector< std::pair< size_t, size_t > > counts( tips.size(), { 0, 0 } );
+        
+        saturated.assign( tips.size(), false );
+        
+        this->reset( tips.size() + 1 );
+        
+        {
+            std::vector< uint64_t > bits( this->_words, 0 );
+            
+            for( size_t i = 0; i < tips.size() + 1; i++ )
+            {
+                size_t n( this->node( ( i == 0 ) ? base : tips[ i - 1 ] ) );
+                
+                if( n == npos )
+                {
+                    throw std::runtime_error( "Cannot lookup commit" );
+                }
+                
+                std::fill( bits.begin(), bits.end(), 0 );
+                
+                bits[ i / 64 ] = static_cast< uint64_t >( 1 ) << ( i % 64 );
+                
+                this->mark( n, bits.data() );
+            }
+        }
+        
+        this->walk();
+        
+        /*
+         * When the walk was cut short, only processed commits are counted,
+         * giving lower bounds. A tip's counts are saturated if a commit still
+         * queued was reached by either the base or the tip, but not both.
+         */
+        if( this->_stopped )
+        {
+            for( size_t n = 0; n < this->_nodes.size(); n++ )
+            {
+                const uint64_t * bits( this->_bits.data() + n * this->_words );
+                uint64_t         inBase( bits[ 0 ] & 1 );
+                
+                if( this->_nodes[ n ]._queued == false || this->full( n ) )
+                {
+                    continue;
+                }
+                
+                for( size_t i = 0; i < tips.size(); i++ )
+                {
+                    if( ( ( bits[ ( i + 1 ) / 64 ] >> ( ( i + 1 ) % 64 ) ) & 1 ) != inBase )
+                    {
+                        saturated[ i ] = true;
+                    }
+                }
+            }
+        }
+        
+        for( size_t n = 0; n < this->_nodes.size(); n++ )
+        {
+            const uint64_t * bits( this->_bits.data() + n * this->_words );
+            bool             inBase( ( bits[ 0 ] & 1 ) != 0 );
+            
+            if( this->full( n ) || ( this->_stopped && this->_nodes[ n ]._queued ) )
+            {
+                continue;
+            }
+            
+            for( size_t w = 0; w < this->_words; w++ )
+            {
+                uint64_t x( ( inBase ) ? ~( bits[ w ] ) : bits[ w ] );
+                
+                x &= this->_full[ w ];
+                
+                if( w == 0 )
+                {
+                    x &= ~static_cast< uint64_t >( 1 );
+                }
+                
+                while( x != 0 )
+                {
+                    size_t i( w * 64 + static_cast< size_t >( __builtin_ctzll( x ) ) - 1 );
+                    
+                    if( inBase )
+                    {
+                        counts[ i ].first++;
+                    }
+                    else
+                    {
+                        counts[ i ].second++;
+                    }
+                    
+                    x &= x - 1;
+                }
+            }
+        }
+        
+        this->reset( 0 );
+        
+        return counts;
+    }
+    
+    std::vector< std::pair< size_t, size_t > > Graph::IMPL::pairs( const std::vector< std::pair< git_oid, git_oid > > & pairs )
+    {
+        std::vector< std::pair< size_t, size_t > > counts( pairs.size(), { 0, 0 } );
+        uint64_t                                   even( 0x5555555555555555ULL );
+        
+        this->reset( pairs.size() * 2 );
+        
+        {
+            std::vector< uint64_t > bits( this->_words, 0 );
+            
+            for( size_t i = 0; i < pairs.size() * 2; i++ )
+            {
+                size_t n( this->node( ( i % 2 == 0 ) ? pairs[ i / 2 ].first : pairs[ i / 2 ].second ) );
+                
+                if( n == npos )
+                {
+                    throw std::runtime_error( "Cannot lookup commit" );
+                }
+                
+                std::fill( bits.begin(), bits.end(), 0 );
+                
+                bits[ i / 64 ] = static_cast< uint64_t >( 1 ) << ( i % 64 );
+                
+                this->mark( n, bits.data() );
+            }
+        }
+        
+        this->walk();
+        
+        /*
+         * Each pair owns two adjacent bits, so the commits reached by only
+         * one side of every pair in a word are found with a few masks.
+         */
+        for( size_t n = 0; n < this->_nodes.size(); n++ )
+        {
+            const uint64_t * bits( this->_bits.data() + n * this->_words );
+            
+            if( this->full( n ) )
+            {
+                continue;
+            }
+            
+            for( size_t w = 0; w < this->_words; w++ )
+            {
+                uint64_t first( bits[ w ] & even & this->_full[ w ] );
+                uint64_t second( ( bits[ w ] >> 1 ) & even & this->_full[ w ] );
+                uint64_t x( first & ~second );
+                uint64_t y( second & ~first );
+                
+                while( x != 0 )
+                {
+                    counts[ ( w * 64 + static_cast< size_t >( __builtin_ctzll( x ) ) ) / 2 ].first++;
+                    
+                    x &= x - 1;
+                }
+                
+                while( y != 0 )
+                {
+                    counts[ ( w * 64 + static_cast< size_t >( __builtin_ctzll( y ) ) ) / 2 ].second++;
+                    
+                    y &= y - 1;
+                }
+            }
+        }
+        
+        this->reset( 0 );
+        
+        return counts;
+    }
+    
+    std::vector< std::vector< std::pair< size_t, size_t > > > Graph::IMPL::matrix( const std::vector< git_oid > & tips )
+    {
+        std::vector< std::vector< std::pair< size_t, size_t > > > counts( tips.size(), std::vector< std::pair< size_t, size_t > >( tips.size(), { 0, 0 } ) );
+        std::map< std::vector< uint64_t >, size_t >               sets;
+        
+        this->reset( tips.size() );
+        
+        {
+            std::vector< uint64_t > bits( this->_words, 0 );
+            
+            for( size_t i = 0; i < tips.size(); i++ )
+            {
+                size_t n( this->node( tips[ i ] ) );
+                
+                if( n == npos )
+                {
+                    throw std::runtime_error( "Cannot lookup commit" );
+                }
+                
+                std::fill( bits.begin(), bits.end(), 0 );
+                
+                bits[ i / 64 ] = static_cast< uint64_t >( 1 ) << ( i % 64 );
+                
+                this->mark( n, bits.data() );
+            }
+        }
+        
+        this->walk();
+        
+        /*
+         * All tips are walked at once. A commit reached by tip i but not by
+         * tip j counts towards both cells of the pair. Commits sharing the
+         * same set of tips are grouped first, as there are usually far fewer
+         * distinct sets than commits.
+         */
+        for( size_t n = 0; n < this->_nodes.size(); n++ )
+        {
+            const uint64_t * bits( this->_bits.data() + n * this->_words );
+            
+            if( this->full( n ) == false )
+            {
+                sets[ std::vector< uint64_t >( bits, bits + this->_words ) ]++;
+            }
+        }
+        
+        for( const auto & p: sets )
+        {
+            std::vector< size_t > in;
+            std::vector< size_t > out;
+            
+            for( size_t i = 0; i < tips.size(); i++ )
+            {
+                if( ( ( p.first[ i / 64 ] >> ( i % 64 ) ) & 1 ) != 0 )
+                {
+                    in.push_back( i );
+                }
+                else
+                {
+                    out.push_back( i );
+                }
+            }
+            
+            for( size_t i: in )
+            {
+                for( size_t j: out )
+                {
+                    counts[ i ][ j ].first  += p.second;
+                    counts[ j ][ i ].second += p.second;
+                }
+            }
+        }
+        
+        this->reset( 0 );
+        
+        return counts;
+    }
+    
+    bool Graph::IMPL::reachable( const PackBitmap & bitmap, const git_oid & tip, std::vector< uint64_t > & bits, std::unordered_set< git_oid, OIDHash, OIDEqual > & extra )
+    {
+        std::vector< git_oid >                           stack( { tip } );
+        std::vector< git_oid >                           parents;
+        std::unordered_set< git_oid, OIDHash, OIDEqual > seen;
+        size_t                                           walked( 0 );
+        
+        bits.assign( ( bitmap.count() + 63 ) / 64, 0 );
+        
+        while( stack.size() > 0 )
+        {
+            git_oid oid( stack.back() );
+            size_t  position( 0 );
+            
+            stack.pop_back();
+            
+            if( bitmap.find( oid, position ) )
+            {
+                if( ( bits[ position / 64 ] & ( static_cast< uint64_t >( 1 ) << ( position % 64 ) ) ) != 0 || bitmap.reachable( position, bits ) )
+                {
+                    continue;
+                }
+                
+                bits[ position / 64 ] |= static_cast< uint64_t >( 1 ) << ( position % 64 );
+            }
+            else if( extra.insert( oid ).second == false )
+            {
+                continue;
+            }
+            
+            if( ++walked > maxBitmapWalk || this->parents( oid, parents ) == false )
+            {
+                return false;
+            }
+            
+            stack.insert( stack.end(), parents.begin(), parents.end() );
+        }
+        
+        return true;
+    }
+    
+    bool Graph::IMPL::parents( const git_oid & oid, std::vector< git_oid > & parents )
+    {
+        CommitHandle commit;
+        size_t       position( 0 );
+        
+        parents.clear();
+        
+        if( this->_commitGraph->find( oid, position ) )
+        {
+            std::vector< size_t > positions;
+            
+            this->_commitGraph->parents( position, positions );
+            
+            for( size_t p: positions )
+            {
+                const git_oid * parent( this->_commitGraph->oid( p ) );
+                
+                if( parent == nullptr )
+                {
+                    return false;
+                }
+                
+                parents.push_back( *( parent ) );
+            }
+            
+            return true;
+        }
+        
+        if( git_commit_lookup( commit.out(), this->_repos, &oid ) != 0 || commit == nullptr )
+        {
+            return false;
+        }
+        
+        for( unsigned int i = 0; i < git_commit_parentcount( commit ); i++ )
+        {
+            const git_oid * parent( git_commit_parent_id( commit, i ) );
+            
+            if( parent != nullptr )
+            {
+                parents.push_back( *( parent ) );
+            }
+        }
+        
+        return true;
+    }
+    
+    bool Graph::IMPL::advance( const git_oid & tip, const git_oid & previous, const git_oid & other, size_t & count, size_t & outside )
+    {
+        std::vector< git_oid > commits;
+        std::vector< git_oid > parents;
+        bool                   forward( false );
+        
+        count   = 0;
+        outside = 0;
+        
+        if( OIDEqual()( tip, previous ) )
+        {
+            return true;
+        }
+        
+        if( this->revwalk( { tip }, { previous }, commits ) == false )
+        {
+            return false;
+        }
+        
+        /* The previous tip is reachable only if one of the new commits is its child */
+        for( const auto & commit: commits )
+        {
+            if( this->parents( commit, parents ) == false )
+            {
+                return false;
+            }
+            
+            for( const auto & parent: parents )
+            {
+                forward = forward || OIDEqual()( parent, previous );
+            }
+        }
+        
+        if( forward == false )
+        {
+            return false;
+        }
+        
+        count = commits.size();
+        
+        if( this->revwalk( { tip }, { previous, other }, commits ) == false )
+        {
+            return false;
+        }
+        
+        outside = commits.size();
+        
+        return true;
+    }
+    
+    bool Graph::IMPL::revwalk( const std::vector< git_oid > & push, const std::vector< git_oid > & hide, std::vector< git_oid > & commits )
+    {
+        RevwalkHandle walk;
+        git_oid       oid;
+        bool          success( true );
+        
+        commits.clear();
+        
+        if( git_revwalk_new( walk.out(), this->_repos ) != 0 || walk == nullptr )
+        {
+            return false;
+        }
+        
+        for( const auto & p: push )
+        {
+            success = success && git_revwalk_push( walk, &p ) == 0;
+        }
+        
+        for( const auto & h: hide )
+        {
+            success = success && git_revwalk_hide( walk, &h ) == 0;
+        }
+        
+        while( success && git_revwalk_next( &oid, walk ) == 0 )
+        {
+            if( commits.size() == maxFastForward )
+            {
+                success = false;
+            }
+            
+            commits.push_back( oid );
+        }
+        
+        return success;
+    }
+    
+    void Graph::IMPL::reset( size_t count )
+    {
+        this->_words   = ( count + 63 ) / 64;
+        this->_pending = 0;
+        this->_stopped = false;
+        
+        this->_full.assign( this->_words, ~static_cast< uint64_t >( 0 ) );
+        this->_bits.clear();
+        this->_nodes.clear();
+        this->_index.clear();
+        this->_positions.clear();
+        
+        this->_queue = {};
+        
+        if( count % 64 != 0 )
+        {
+            this->_full.back() = ( static_cast< uint64_t >( 1 ) << ( count % 64 ) ) - 1;
+        }
+    }
+    
+    size_t Graph::IMPL::node( const git_oid & oid )
+    {
+        CommitHandle commit;
+        Node         node;
+        
+        {
+            auto it( this->_index.find( oid ) );
+            
+            if( it != this->_index.end() )
+            {
+                return it->second;
+            }
+        }
+        
+        {
+            size_t position( 0 );
+            
+            if( this->_commitGraph->find( oid, position ) )
+            {
+                return this->node( position );
+            }
+        }
+        
+        if( git_commit_lookup( commit.out(), this->_repos, &oid ) != 0 || commit == nullptr )
+        {
+            return npos;
+        }
+        
+        node._oid        = oid;
+        node._time       = git_commit_time( commit );
+        node._generation = CommitGraph::noGeneration;
+        node._queued     = false;
+        
+        for( unsigned int i = 0; i < git_commit_parentcount( commit ); i++ )
+        {
+            const git_oid * parent( git_commit_parent_id( commit, i ) );
+            
+            if( parent != nullptr )
+            {
+                node._parents.push_back( *( parent ) );
+            }
+        }
+        
+        this->_nodes.push_back( node );
+        this->_bits.resize( this->_bits.size() + this->_words, 0 );
+        
+        this->_index[ oid ] = this->_nodes.size() - 1;
+        
+        return this->_nodes.size() - 1;
+    }
+    
+    size_t Graph::IMPL::node( size_t position )
+    {
+        const git_oid * oid( this->_commitGraph->oid( position ) );
+        Node            node;
+        
+        {
+            auto it( this->_positions.find( position ) );
+            
+            if( it != this->_positions.end() )
+            {
+                return it->second;
+            }
+        }
+        
+        if( oid == nullptr )
+        {
+            return npos;
+        }
+        
+        node._oid        = *( oid );
+        node._time       = this->_commitGraph->time( position );
+        node._generation = this->_commitGraph->generation( position );
+        node._queued     = false;
+        
+        this->_commitGraph->parents( position, node._positions );
+        
+        this->_nodes.push_back( node );
+        this->_bits.resize( this->_bits.size() + this->_words, 0 );
+        
+        this->_index[ *( oid ) ]     = this->_nodes.size() - 1;
+        this->_positions[ position ] = this->_nodes.size() - 1;
+        
+        return this->_nodes.size() - 1;
+    }
+    
+    void Graph::IMPL::mark( size_t n, const uint64_t * bits )
+    {
+        uint64_t * dest( this->_bits.data() + n * this->_words );
+        bool       wasFull( this->full( n ) );
+        bool       changed( false );
+        
+        for( size_t w = 0; w < this->_words; w++ )
+        {
+            if( ( dest[ w ] | bits[ w ] ) != dest[ w ] )
+            {
+                dest[ w ] |= bits[ w ];
+                changed    = true;
+            }
+        }
+        
+        if( changed == false )
+        {
+            return;
+        }
+        
+        if( this->_nodes[ n ]._queued == false )
+        {
+            this->push( n );
+        }
+        else if( wasFull == false && this->full( n ) )
+        {
+            this->_pending--;
+        }
+    }
+    
+    void Graph::IMPL::push( size_t n )
+    {
+        this->_nodes[ n ]._queued = true;
+        
+        this->_queue.push( { this->_nodes[ n ]._generation, this->_nodes[ n ]._time, n } );
+        
+        if( this->full( n ) == false )
+        {
+            this->_pending++;
+        }
+    }
+    
+    bool Graph::IMPL::full( size_t n ) const
+    {
+        const uint64_t * bits( this->_bits.data() + n * this->_words );
+        
+        for( size_t w = 0; w < this->_words; w++ )
+        {
+            if( ( bits[ w ] & this->_full[ w ] ) != this->_full[ w ] )
+            {
+                return false;
+            }
+        }
+        
+        return true;
+    }
+    
+    void Graph::IMPL::walk( void )
+    {
+        std::vector< uint64_t >               bits( this->_words, 0 );
+        git_time_t                            oldest( std::numeric_limits< git_time_t >::max() );
+        size_t                                popped( 0 );
+        std::chrono::steady_clock::time_point start( std::chrono::steady_clock::now() );
+        
+        /*
+         * Commits are processed newest first, so a commit's bitset is usually
+         * complete by the time it is popped. Commits reached by every tip can't
+         * change any count, so the walk stops once only those remain in the
+         * queue, and once they are older than every commit still counted.
+         * The latter catches clock skew, where a commit receiving new bits
+         * after having been processed is simply queued again.
+         * Commits found in the commit-graph are ordered by generation number
+         * instead, which is a topological order: once only those remain, no
+         * commit can receive new bits after being processed, so the walk can
+         * stop as soon as only full commits are queued.
+         */
+        while( this->_queue.empty() == false )
+        {
+            size_t n( this->_queue.top()._node );
+            
+            if( this->_pending == 0 && ( this->_queue.top()._generation != CommitGraph::noGeneration || this->_queue.top()._time < oldest ) )
+            {
+                break;
+            }
+            
+            if( this->_maxCommits > 0 && popped >= this->_maxCommits )
+            {
+                this->_stopped = true;
+                
+                break;
+            }
+            
+            /* Wall time is only checked every 256 commits, as reading the clock isn't free */
+            if( this->_maxTime > 0 && popped % 256 == 255 && std::chrono::steady_clock::now() - start >= std::chrono::milliseconds( this->_maxTime ) )
+            {
+                this->_stopped = true;
+                
+                break;
+            }
+            
+            popped++;
+            
+            this->_queue.pop();
+            
+            this->_nodes[ n ]._queued = false;
+            
+            if( this->full( n ) == false )
+            {
+                this->_pending--;
+                
+                oldest = std::min( oldest, this->_nodes[ n ]._time );
+            }
+            
+            std::copy( this->_bits.begin() + static_cast< std::ptrdiff_t >( n * this->_words ), this->_bits.begin() + static_cast< std::ptrdiff_t >( ( n + 1 ) * this->_words ), bits.begin() );
+            
+            for( size_t i = 0; i < this->_nodes[ n ]._parents.size(); i++ )
+            {
+                git_oid parent( this->_nodes[ n ]._parents[ i ] );
+                size_t  p( this->node( parent ) );
+                
+                if( p != npos )
+                {
+                    this->mark( p, bits.data() );
+                }
+            }
+            
+            for( size_t i = 0; i < this->_nodes[ n ]._positions.size(); i++ )
+            {
+                size_t p( this->node( this->_nodes[ n ]._positions[ i ] ) );
+                
+                if( p != npos )
+                {
+                    this->mark( p, bits.data() );
+                }
+            }
+        }
+    }
+}
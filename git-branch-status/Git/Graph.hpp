@@ -0,0 +1,70 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @header      Graph.hpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef GIT_GRAPH_HPP
+#define GIT_GRAPH_HPP
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <git2.h>
+#include "Optional.hpp"
+
+namespace Git
+{
+    class Graph
+    {
+        public:
+            
+            Graph( git_repository * repos );
+            Graph( git_repository * repos, size_t maxCommits, size_t maxMilliseconds );
+            Graph( const Graph & o );
+            ~Graph( void );
+            
+            Graph & operator =( Graph o );
+            
+            std::vector< std::pair< size_t, size_t > >                aheadBehind( const git_oid & base, const std::vector< git_oid > & tips )                                                                                        const;
+            std::vector< std::pair< size_t, size_t > >                aheadBehind( const git_oid & base, const std::vector< git_oid > & tips, std::vector< bool > & saturated )                                                       const;
+            std::vector< std::pair< size_t, size_t > >                aheadBehind( const std::vector< std::pair< git_oid, git_oid > > & pairs )                                                                                       const;
+            std::vector< std::vector< std::pair< size_t, size_t > > > matrix( const std::vector< git_oid > & tips )                                                                                                                   const;
+            Utility::Optional< std::pair< size_t, size_t > >          fastForward( const git_oid & base, const git_oid & tip, const git_oid & previousBase, const git_oid & previousTip, const std::pair< size_t, size_t > & counts ) const;
+            
+            friend void swap( Graph & o1, Graph & o2 );
+            
+        private:
+            
+            class IMPL;
+            
+            std::shared_ptr< IMPL > impl;
+    };
+}
+
+#endif /* GIT_GRAPH_HPP */
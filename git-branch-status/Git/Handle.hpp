@@ -0,0 +1,170 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @header      Handle.hpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef GIT_HANDLE_HPP
+#define GIT_HANDLE_HPP
+
+#include <cstring>
+#include <utility>
+#include <git2.h>
+
+namespace Git
+{
+    /*
+     * Owns a libgit2 object, freed with the given function. Handles are
+     * move-only, and convert to the raw pointer so they can be passed to
+     * libgit2 directly. out() releases the current object and gives the
+     * address libgit2 functions returning an object expect.
+     */
+    template< typename _T_, void ( * _F_ )( _T_ * ) >
+    class Handle
+    {
+        public:
+            
+            Handle( void ):
+                _object( nullptr )
+            {}
+            
+            explicit Handle( _T_ * object ):
+                _object( object )
+            {}
+            
+            Handle( const Handle & o ) = delete;
+            
+            Handle( Handle && o ) noexcept:
+                _object( o.release() )
+            {}
+            
+            ~Handle( void )
+            {
+                this->reset();
+            }
+            
+            Handle & operator =( const Handle & o ) = delete;
+            
+            Handle & operator =( Handle && o ) noexcept
+            {
+                this->reset( o.release() );
+                
+                return *( this );
+            }
+            
+            operator _T_ *() const
+            {
+                return this->_object;
+            }
+            
+            _T_ * get( void ) const
+            {
+                return this->_object;
+            }
+            
+            _T_ ** out( void )
+            {
+                this->reset();
+                
+                return &( this->_object );
+            }
+            
+            _T_ * release( void )
+            {
+                _T_ * object( this->_object );
+                
+                this->_object = nullptr;
+                
+                return object;
+            }
+            
+            void reset( _T_ * object = nullptr )
+            {
+                if( this->_object != nullptr )
+                {
+                    _F_( this->_object );
+                }
+                
+                this->_object = object;
+            }
+            
+        private:
+            
+            _T_ * _object;
+    };
+    
+    /*
+     * Owns a libgit2 structure returned by value, like a string array or a
+     * buffer, disposed with the given function.
+     */
+    template< typename _T_, void ( * _F_ )( _T_ * ) >
+    class Disposable
+    {
+        public:
+            
+            Disposable( void )
+            {
+                memset( &( this->_value ), 0, sizeof( _T_ ) );
+            }
+            
+            Disposable( const Disposable & o ) = delete;
+            
+            ~Disposable( void )
+            {
+                _F_( &( this->_value ) );
+            }
+            
+            Disposable & operator =( const Disposable & o ) = delete;
+            
+            _T_ * get( void )
+            {
+                return &( this->_value );
+            }
+            
+            _T_ * operator ->( void )
+            {
+                return &( this->_value );
+            }
+            
+        private:
+            
+            _T_ _value;
+    };
+    
+    using CommitHandle         = Handle< git_commit,          git_commit_free >;
+    using ConfigHandle         = Handle< git_config,          git_config_free >;
+    using ConfigIteratorHandle = Handle< git_config_iterator, git_config_iterator_free >;
+    using ODBHandle            = Handle< git_odb,             git_odb_free >;
+    using ODBObjectHandle      = Handle< git_odb_object,      git_odb_object_free >;
+    using RemoteHandle         = Handle< git_remote,          git_remote_free >;
+    using RepositoryHandle     = Handle< git_repository,      git_repository_free >;
+    using RevwalkHandle        = Handle< git_revwalk,         git_revwalk_free >;
+    using WorktreeHandle       = Handle< git_worktree,        git_worktree_free >;
+    using StrArray             = Disposable< git_strarray, git_strarray_dispose >;
+    using Buffer               = Disposable< git_buf,      git_buf_dispose >;
+}
+
+#endif /* GIT_HANDLE_HPP */
@@ -0,0 +1,126 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @file        History.cpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include <map>
+#include <mutex>
+#include "History.hpp"
+
+namespace Git
+{
+    class History::IMPL
+    {
+        public:
+            
+            class Entry
+            {
+                public:
+                    
+                    git_oid                     _base;
+                    git_oid                     _tip;
+                    std::pair< size_t, size_t > _counts;
+            };
+            
+            IMPL( void );
+            IMPL( const IMPL & o );
+            ~IMPL( void );
+            
+            std::map< std::string, Entry > _entries;
+            mutable std::mutex             _mtx;
+    };
+    
+    History::History( void ): impl( std::make_shared< IMPL >() )
+    {}
+    
+    History::History( const History & o ): impl( std::make_shared< IMPL >( *( o.impl ) ) )
+    {}
+    
+    History::~History( void )
+    {}
+    
+    History & History::operator =( History o )
+    {
+        swap( *( this ), o );
+        
+        return *( this );
+    }
+    
+    bool History::get( const std::string & name, git_oid & base, git_oid & tip, std::pair< size_t, size_t > & counts ) const
+    {
+        std::lock_guard< std::mutex > l( this->impl->_mtx );
+        
+        if( this->impl->_entries.count( name ) == 0 )
+        {
+            return false;
+        }
+        
+        {
+            const IMPL::Entry & entry( this->impl->_entries.at( name ) );
+            
+            base   = entry._base;
+            tip    = entry._tip;
+            counts = entry._counts;
+        }
+        
+        return true;
+    }
+    
+    void History::set( const std::string & name, const git_oid & base, const git_oid & tip, const std::pair< size_t, size_t > & counts )
+    {
+        std::lock_guard< std::mutex > l( this->impl->_mtx );
+        
+        this->impl->_entries[ name ] = { base, tip, counts };
+    }
+    
+    void History::clear( void )
+    {
+        std::lock_guard< std::mutex > l( this->impl->_mtx );
+        
+        this->impl->_entries.clear();
+    }
+    
+    void swap( History & o1, History & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    History::IMPL::IMPL( void )
+    {}
+    
+    History::IMPL::IMPL( const IMPL & o )
+    {
+        std::lock_guard< std::mutex > l( o._mtx );
+        
+        this->_entries = o._entries;
+    }
+    
+    History::IMPL::~IMPL( void )
+    {}
+}
@@ -0,0 +1,135 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @header      OID.hpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef GIT_OID_HPP
+#define GIT_OID_HPP
+
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <git2.h>
+
+namespace Git
+{
+    class OIDHash
+    {
+        public:
+            
+            std::size_t operator ()( const git_oid & oid ) const
+            {
+                std::size_t h( 0 );
+                
+                memcpy( &h, oid.id, sizeof( h ) );
+                
+                return h;
+            }
+    };
+    
+    class OIDEqual
+    {
+        public:
+            
+            bool operator ()( const git_oid & o1, const git_oid & o2 ) const
+            {
+                return memcmp( o1.id, o2.id, GIT_OID_RAWSZ ) == 0;
+            }
+    };
+    
+    /*
+     * Hexadecimal form of an OID, in a fixed buffer, so hashes can be shown
+     * without allocating. Four bytes are formatted at once: their nibbles
+     * are spread to one per byte of a 64-bit word, then turned to ASCII
+     * with a carry-free addition, letters getting the extra offset.
+     */
+    class OIDString
+    {
+        public:
+            
+            OIDString( const git_oid & oid, size_t length = 0 ):
+                _length( ( length == 0 || length > GIT_OID_HEXSZ ) ? GIT_OID_HEXSZ : length )
+            {
+                for( size_t i = 0; i < this->_length; i += 8 )
+                {
+                    const unsigned char * p( oid.id + ( i / 2 ) );
+                    uint64_t              x( ( static_cast< uint64_t >( p[ 0 ] ) << 24 ) | ( static_cast< uint64_t >( p[ 1 ] ) << 16 ) | ( static_cast< uint64_t >( p[ 2 ] ) << 8 ) | p[ 3 ] );
+                    
+                    x  = ( ( x & 0x00000000FFFF0000 ) << 16 ) | ( x & 0x000000000000FFFF );
+                    x  = ( ( x & 0x0000FF000000FF00 ) <<  8 ) | ( x & 0x000000FF000000FF );
+                    x  = ( ( x & 0x00F000F000F000F0 ) <<  4 ) | ( x & 0x000F000F000F000F );
+                    x += 0x3030303030303030 + ( ( ( x + 0x0606060606060606 ) >> 4 ) & 0x0101010101010101 ) * ( 'a' - '0' - 10 );
+                    
+                    for( size_t j = 0; j < 8; j++ )
+                    {
+                        this->_hex[ i + j ] = static_cast< char >( x >> ( 56 - ( j * 8 ) ) );
+                    }
+                }
+                
+                this->_hex[ this->_length ] = 0;
+            }
+            
+            std::string_view view( void ) const
+            {
+                return std::string_view( this->_hex, this->_length );
+            }
+            
+            const char * c_str( void ) const
+            {
+                return this->_hex;
+            }
+            
+        private:
+            
+            char   _hex[ GIT_OID_HEXSZ + 1 ];
+            size_t _length;
+    };
+    
+    class OIDPairHash
+    {
+        public:
+            
+            std::size_t operator ()( const std::pair< git_oid, git_oid > & p ) const
+            {
+                return OIDHash()( p.first ) * 31 + OIDHash()( p.second );
+            }
+    };
+    
+    class OIDPairEqual
+    {
+        public:
+            
+            bool operator ()( const std::pair< git_oid, git_oid > & p1, const std::pair< git_oid, git_oid > & p2 ) const
+            {
+                return OIDEqual()( p1.first, p2.first ) && OIDEqual()( p1.second, p2.second );
+            }
+    };
+}
+
+#endif /* GIT_OID_HPP */
@@ -0,0 +1,603 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @file        PackBitmap.cpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include <stdexcept>
+#include <cstring>
+#include <mutex>
+#include <map>
+#include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "PackBitmap.hpp"
+#include "LRUCache.hpp"
+
+/*
+ * Reader for pack reachability bitmaps (.bitmap, version 1) and their pack
+ * index (.idx, version 2). Bit positions follow the pack order, i.e. the
+ * objects sorted by pack offset. Stored bitmaps are EWAH-compressed and may
+ * be XORed with a previous entry; they are decompressed on demand and kept
+ * in a small LRU cache.
+ */
+
+namespace Git
+{
+    class PackBitmap::IMPL
+    {
+        public:
+            
+            class Entry
+            {
+                public:
+                    
+                    size_t _xor;
+                    size_t _offset;
+            };
+            
+            class Directory
+            {
+                public:
+                    
+                    time_t                        _time;
+                    long                          _nanoseconds;
+                    std::shared_ptr< PackBitmap > _bitmap;
+            };
+            
+            class Map
+            {
+                public:
+                    
+                    Map( void );
+                    
+                    bool load( const std::string & path );
+                    void unload( void );
+                    
+                    const uint8_t * _data;
+                    size_t          _size;
+            };
+            
+            static uint32_t read32( const uint8_t * p );
+            static uint64_t read64( const uint8_t * p );
+            
+            IMPL( const std::string & path );
+            ~IMPL( void );
+            
+            bool load( void );
+            bool loadIndex( void );
+            bool ewah( size_t offset, size_t & end )                                   const;
+            bool decode( size_t offset, std::vector< uint64_t > & bits, bool combine ) const;
+            bool resolve( size_t entry, std::vector< uint64_t > & bits )                const;
+            
+            std::string                                                                           _path;
+            Map                                                                                   _bitmap;
+            Map                                                                                   _index;
+            size_t                                                                                _count;
+            size_t                                                                                _words;
+            const uint8_t                                                                       * _fanout;
+            const uint8_t                                                                       * _oids;
+            std::vector< uint32_t >                                                               _positions;
+            std::vector< uint64_t >                                                               _commits;
+            std::vector< Entry >                                                                  _entries;
+            std::unordered_map< size_t, size_t >                                                  _bitmaps;
+            mutable Utility::LRUCache< size_t, std::shared_ptr< const std::vector< uint64_t > > > _cache;
+    };
+    
+    std::shared_ptr< PackBitmap > PackBitmap::shared( git_repository * repos )
+    {
+        static std::mutex                               * mtx( new std::mutex() );
+        static std::map< std::string, IMPL::Directory > * directories( new std::map< std::string, IMPL::Directory >() );
+        
+        std::string directory( std::string( git_repository_commondir( repos ) ) + "/objects/pack" );
+        std::string path;
+        struct stat st;
+        
+        memset( &st, 0, sizeof( struct stat ) );
+        stat( directory.c_str(), &st );
+        
+        {
+            std::lock_guard< std::mutex > l( *( mtx ) );
+            IMPL::Directory             & entry( ( *( directories ) )[ directory ] );
+            
+            #ifdef __APPLE__
+            long nanoseconds( st.st_mtimespec.tv_nsec );
+            #else
+            long nanoseconds( st.st_mtim.tv_nsec );
+            #endif
+            
+            /* Packs are only added or removed by renames and unlinks, which change the directory's mtime */
+            if( entry._bitmap != nullptr && entry._time == st.st_mtime && entry._nanoseconds == nanoseconds )
+            {
+                return entry._bitmap;
+            }
+            
+            entry._time        = st.st_mtime;
+            entry._nanoseconds = nanoseconds;
+            
+            {
+                DIR * dir( opendir( directory.c_str() ) );
+                
+                if( dir != nullptr )
+                {
+                    struct dirent * e( nullptr );
+                    
+                    while( ( e = readdir( dir ) ) != nullptr )
+                    {
+                        std::string name( e->d_name );
+                        
+                        if( name.length() > 12 && name.substr( 0, 5 ) == "pack-" && name.substr( name.length() - 7 ) == ".bitmap" )
+                        {
+                            path = directory + "/" + name;
+                            
+                            break;
+                        }
+                    }
+                    
+                    closedir( dir );
+                }
+            }
+            
+            /* Packs are immutable, so a bitmap is identified by its file name */
+            if( entry._bitmap == nullptr || entry._bitmap->path() != path )
+            {
+                entry._bitmap = std::make_shared< PackBitmap >( path );
+            }
+            
+            return entry._bitmap;
+        }
+    }
+    
+    PackBitmap::PackBitmap( const std::string & path ): impl( std::make_shared< IMPL >( path ) )
+    {}
+    
+    PackBitmap::~PackBitmap( void )
+    {}
+    
+    std::string PackBitmap::path( void ) const
+    {
+        return this->impl->_path;
+    }
+    
+    size_t PackBitmap::count( void ) const
+    {
+        return this->impl->_count;
+    }
+    
+    bool PackBitmap::find( const git_oid & oid, size_t & position ) const
+    {
+        size_t low( 0 );
+        size_t high( 0 );
+        
+        if( this->impl->_count == 0 )
+        {
+            return false;
+        }
+        
+        low  = ( oid.id[ 0 ] == 0 ) ? 0 : IMPL::read32( this->impl->_fanout + ( oid.id[ 0 ] - 1 ) * 4 );
+        high = IMPL::read32( this->impl->_fanout + oid.id[ 0 ] * 4 );
+        
+        while( low < high )
+        {
+            size_t middle( low + ( high - low ) / 2 );
+            int    cmp( memcmp( this->impl->_oids + middle * GIT_OID_RAWSZ, oid.id, GIT_OID_RAWSZ ) );
+            
+            if( cmp == 0 )
+            {
+                position = this->impl->_positions[ middle ];
+                
+                return true;
+            }
+            else if( cmp < 0 )
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+        
+        return false;
+    }
+    
+    bool PackBitmap::reachable( size_t position, std::vector< uint64_t > & bits ) const
+    {
+        size_t entry( 0 );
+        
+        if( this->impl->_bitmaps.count( position ) == 0 )
+        {
+            return false;
+        }
+        
+        entry = this->impl->_bitmaps.at( position );
+        
+        bits.resize( this->impl->_words, 0 );
+        
+        {
+            Utility::Optional< std::shared_ptr< const std::vector< uint64_t > > > cached( this->impl->_cache.get( entry ) );
+            std::shared_ptr< const std::vector< uint64_t > >                      resolved;
+            
+            if( cached.hasValue() )
+            {
+                resolved = *( cached );
+            }
+            else
+            {
+                std::vector< uint64_t > decoded;
+                
+                if( this->impl->resolve( entry, decoded ) == false )
+                {
+                    return false;
+                }
+                
+                resolved = std::make_shared< const std::vector< uint64_t > >( std::move( decoded ) );
+                
+                this->impl->_cache.set( entry, resolved );
+            }
+            
+            /* Cached bitmaps are shared and never modified, so they are ORed in place */
+            for( size_t i = 0; i < this->impl->_words; i++ )
+            {
+                bits[ i ] |= ( *( resolved ) )[ i ];
+            }
+        }
+        
+        return true;
+    }
+    
+    size_t PackBitmap::difference( const std::vector< uint64_t > & bits, const std::vector< uint64_t > & exclude ) const
+    {
+        const uint64_t * a( bits.data() );
+        const uint64_t * b( exclude.data() );
+        const uint64_t * c( this->impl->_commits.data() );
+        size_t           n( std::min( { bits.size(), exclude.size(), this->impl->_commits.size() } ) );
+        size_t           count( 0 );
+        
+        /* Branch-free so the compiler can vectorize the popcounts */
+        for( size_t i = 0; i < n; i++ )
+        {
+            count += static_cast< size_t >( __builtin_popcountll( a[ i ] & ~( b[ i ] ) & c[ i ] ) );
+        }
+        
+        for( size_t i = n; i < std::min( bits.size(), this->impl->_commits.size() ); i++ )
+        {
+            count += static_cast< size_t >( __builtin_popcountll( a[ i ] & c[ i ] ) );
+        }
+        
+        return count;
+    }
+    
+    uint32_t PackBitmap::IMPL::read32( const uint8_t * p )
+    {
+        return ( static_cast< uint32_t >( p[ 0 ] ) << 24 )
+             | ( static_cast< uint32_t >( p[ 1 ] ) << 16 )
+             | ( static_cast< uint32_t >( p[ 2 ] ) <<  8 )
+             |   static_cast< uint32_t >( p[ 3 ] );
+    }
+    
+    uint64_t PackBitmap::IMPL::read64( const uint8_t * p )
+    {
+        return ( static_cast< uint64_t >( read32( p ) ) << 32 ) | read32( p + 4 );
+    }
+    
+    PackBitmap::IMPL::IMPL( const std::string & path ):
+        _path( path ),
+        _count( 0 ),
+        _words( 0 ),
+        _fanout( nullptr ),
+        _oids( nullptr ),
+        _cache( 64 )
+    {
+        if( path.length() > 0 && this->load() == false )
+        {
+            this->_count = 0;
+            
+            this->_bitmap.unload();
+            this->_index.unload();
+        }
+    }
+    
+    PackBitmap::IMPL::~IMPL( void )
+    {
+        this->_bitmap.unload();
+        this->_index.unload();
+    }
+    
+    bool PackBitmap::IMPL::load( void )
+    {
+        size_t offset( 32 );
+        size_t entries( 0 );
+        
+        if( this->_bitmap.load( this->_path ) == false || this->loadIndex() == false )
+        {
+            return false;
+        }
+        
+        /* Header: signature, version, options, entry count, pack checksum */
+        if( this->_bitmap._size < 32 + GIT_OID_RAWSZ || memcmp( this->_bitmap._data, "BITM", 4 ) != 0 || this->_bitmap._data[ 4 ] != 0 || this->_bitmap._data[ 5 ] != 1 )
+        {
+            return false;
+        }
+        
+        if( memcmp( this->_bitmap._data + 12, this->_index._data + this->_index._size - 2 * GIT_OID_RAWSZ, GIT_OID_RAWSZ ) != 0 )
+        {
+            return false;
+        }
+        
+        entries = read32( this->_bitmap._data + 8 );
+        
+        /* Type bitmaps: commits, trees, blobs, tags */
+        for( size_t i = 0; i < 4; i++ )
+        {
+            size_t end( 0 );
+            
+            if( this->ewah( offset, end ) == false )
+            {
+                return false;
+            }
+            
+            if( i == 0 && this->decode( offset, this->_commits, false ) == false )
+            {
+                return false;
+            }
+            
+            offset = end;
+        }
+        
+        for( size_t i = 0; i < entries; i++ )
+        {
+            Entry    entry;
+            uint32_t index( 0 );
+            size_t   end( 0 );
+            
+            if( offset + 6 > this->_bitmap._size )
+            {
+                return false;
+            }
+            
+            index         = read32( this->_bitmap._data + offset );
+            entry._xor    = this->_bitmap._data[ offset + 4 ];
+            entry._offset = offset + 6;
+            
+            if( index >= this->_count || entry._xor > i || this->ewah( entry._offset, end ) == false )
+            {
+                return false;
+            }
+            
+            this->_bitmaps[ this->_positions[ index ] ] = this->_entries.size();
+            
+            this->_entries.push_back( entry );
+            
+            offset = end;
+        }
+        
+        return true;
+    }
+    
+    bool PackBitmap::IMPL::loadIndex( void )
+    {
+        std::string path( this->_path.substr( 0, this->_path.length() - 7 ) + ".idx" );
+        
+        if( this->_index.load( path ) == false )
+        {
+            return false;
+        }
+        
+        /* Version 2 only: magic, version, fanout, oids, CRCs, offsets, large offsets, checksums */
+        if( this->_index._size < 8 + 256 * 4 + 2 * GIT_OID_RAWSZ || memcmp( this->_index._data, "\377tOc", 4 ) != 0 || read32( this->_index._data + 4 ) != 2 )
+        {
+            return false;
+        }
+        
+        this->_fanout = this->_index._data + 8;
+        this->_oids   = this->_fanout + 256 * 4;
+        this->_count  = read32( this->_fanout + 255 * 4 );
+        this->_words  = ( this->_count + 63 ) / 64;
+        
+        if( 8 + 256 * 4 + this->_count * ( GIT_OID_RAWSZ + 8 ) + 2 * GIT_OID_RAWSZ > this->_index._size )
+        {
+            return false;
+        }
+        
+        {
+            const uint8_t                            * offsets( this->_oids + this->_count * ( GIT_OID_RAWSZ + 4 ) );
+            const uint8_t                            * large( offsets + this->_count * 4 );
+            size_t                                     largeCount( ( this->_index._size - 2 * GIT_OID_RAWSZ - static_cast< size_t >( large - this->_index._data ) ) / 8 );
+            std::vector< std::pair< uint64_t, size_t > > order( this->_count );
+            
+            for( size_t i = 0; i < this->_count; i++ )
+            {
+                uint64_t offset( read32( offsets + i * 4 ) );
+                
+                if( ( offset & 0x80000000 ) != 0 )
+                {
+                    offset &= 0x7FFFFFFF;
+                    
+                    if( offset >= largeCount )
+                    {
+                        return false;
+                    }
+                    
+                    offset = read64( large + offset * 8 );
+                }
+                
+                order[ i ] = { offset, i };
+            }
+            
+            std::sort( order.begin(), order.end() );
+            
+            this->_positions.resize( this->_count );
+            
+            for( size_t i = 0; i < this->_count; i++ )
+            {
+                this->_positions[ order[ i ].second ] = static_cast< uint32_t >( i );
+            }
+        }
+        
+        return true;
+    }
+    
+    bool PackBitmap::IMPL::ewah( size_t offset, size_t & end ) const
+    {
+        uint64_t words( 0 );
+        
+        if( offset + 8 > this->_bitmap._size )
+        {
+            return false;
+        }
+        
+        words = read32( this->_bitmap._data + offset + 4 );
+        end   = offset + 8 + words * 8 + 4;
+        
+        return end <= this->_bitmap._size;
+    }
+    
+    bool PackBitmap::IMPL::decode( size_t offset, std::vector< uint64_t > & bits, bool combine ) const
+    {
+        const uint8_t * data( this->_bitmap._data + offset + 8 );
+        size_t          count( read32( this->_bitmap._data + offset + 4 ) );
+        size_t          word( 0 );
+        size_t          i( 0 );
+        
+        bits.resize( this->_words, 0 );
+        
+        /*
+         * Each marker word holds a running bit (bit 0), the number of words
+         * filled with that bit (bits 1-32) and the number of literal words
+         * following the marker (bits 33-63).
+         */
+        while( i < count )
+        {
+            uint64_t marker( read64( data + i * 8 ) );
+            uint64_t fill( ( ( marker & 1 ) != 0 ) ? ~static_cast< uint64_t >( 0 ) : 0 );
+            size_t   running( static_cast< size_t >( ( marker >> 1 ) & 0xFFFFFFFF ) );
+            size_t   literals( static_cast< size_t >( marker >> 33 ) );
+            
+            i++;
+            
+            if( i + literals > count || word + running + literals > this->_words )
+            {
+                return false;
+            }
+            
+            for( size_t j = 0; j < running; j++, word++ )
+            {
+                bits[ word ] = ( combine ) ? bits[ word ] ^ fill : fill;
+            }
+            
+            for( size_t j = 0; j < literals; j++, word++, i++ )
+            {
+                uint64_t literal( read64( data + i * 8 ) );
+                
+                bits[ word ] = ( combine ) ? bits[ word ] ^ literal : literal;
+            }
+        }
+        
+        if( combine == false )
+        {
+            std::fill( bits.begin() + static_cast< std::ptrdiff_t >( word ), bits.end(), 0 );
+        }
+        
+        return true;
+    }
+    
+    bool PackBitmap::IMPL::resolve( size_t entry, std::vector< uint64_t > & bits ) const
+    {
+        if( this->_entries[ entry ]._xor == 0 )
+        {
+            return this->decode( this->_entries[ entry ]._offset, bits, false );
+        }
+        
+        {
+            Utility::Optional< std::shared_ptr< const std::vector< uint64_t > > > cached( this->_cache.get( entry - this->_entries[ entry ]._xor ) );
+            
+            if( cached.hasValue() )
+            {
+                bits = *( *( cached ) );
+            }
+            else if( this->resolve( entry - this->_entries[ entry ]._xor, bits ) == false )
+            {
+                return false;
+            }
+        }
+        
+        return this->decode( this->_entries[ entry ]._offset, bits, true );
+    }
+    
+    PackBitmap::IMPL::Map::Map( void ):
+        _data( nullptr ),
+        _size( 0 )
+    {}
+    
+    bool PackBitmap::IMPL::Map::load( const std::string & path )
+    {
+        int         fd( open( path.c_str(), O_RDONLY ) );
+        struct stat st;
+        
+        if( fd < 0 )
+        {
+            return false;
+        }
+        
+        if( fstat( fd, &st ) != 0 || st.st_size == 0 )
+        {
+            close( fd );
+            
+            return false;
+        }
+        
+        {
+            void * data( mmap( nullptr, static_cast< size_t >( st.st_size ), PROT_READ, MAP_PRIVATE, fd, 0 ) );
+            
+            close( fd );
+            
+            if( data == MAP_FAILED )
+            {
+                return false;
+            }
+            
+            this->_data = static_cast< const uint8_t * >( data );
+            this->_size = static_cast< size_t >( st.st_size );
+        }
+        
+        return true;
+    }
+    
+    void PackBitmap::IMPL::Map::unload( void )
+    {
+        if( this->_data != nullptr )
+        {
+            munmap( const_cast< uint8_t * >( this->_data ), this->_size );
+        }
+        
+        this->_data = nullptr;
+        this->_size = 0;
+    }
+}
@@ -0,0 +1,67 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @header      PackBitmap.hpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef GIT_PACK_BITMAP_HPP
+#define GIT_PACK_BITMAP_HPP
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <git2.h>
+
+namespace Git
+{
+    class PackBitmap
+    {
+        public:
+            
+            static std::shared_ptr< PackBitmap > shared( git_repository * repos );
+            
+            PackBitmap( const std::string & path );
+            PackBitmap( const PackBitmap & o ) = delete;
+            ~PackBitmap( void );
+            
+            PackBitmap & operator =( const PackBitmap & o ) = delete;
+            
+            std::string path( void )                                                                                const;
+            size_t      count( void )                                                                               const;
+            bool        find( const git_oid & oid, size_t & position )                                              const;
+            bool        reachable( size_t position, std::vector< uint64_t > & bits )                                const;
+            size_t      difference( const std::vector< uint64_t > & bits, const std::vector< uint64_t > & exclude ) const;
+            
+        private:
+            
+            class IMPL;
+            
+            std::shared_ptr< IMPL > impl;
+    };
+}
+
+#endif /* GIT_PACK_BITMAP_HPP */
@@ -0,0 +1,161 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @file        RefDelta.cpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "RefDelta.hpp"
+
+namespace Git
+{
+    class RefDelta::IMPL
+    {
+        public:
+            
+            IMPL( void );
+            IMPL( const std::map< std::string, git_oid > & previous, const std::map< std::string, git_oid > & current, const std::string & previousHead, const std::string & currentHead );
+            IMPL( const IMPL & o );
+            ~IMPL( void );
+            
+            std::vector< std::string > _added;
+            std::vector< std::string > _removed;
+            std::vector< std::string > _moved;
+            bool                       _headChanged;
+    };
+    
+    RefDelta::RefDelta( void ): impl( std::make_shared< IMPL >() )
+    {}
+    
+    RefDelta::RefDelta( const std::map< std::string, git_oid > & previous, const std::map< std::string, git_oid > & current, const std::string & previousHead, const std::string & currentHead ): impl( std::make_shared< IMPL >( previous, current, previousHead, currentHead ) )
+    {}
+    
+    RefDelta::RefDelta( const RefDelta & o ): impl( std::make_shared< IMPL >( *( o.impl ) ) )
+    {}
+    
+    RefDelta::~RefDelta( void )
+    {}
+    
+    RefDelta & RefDelta::operator =( RefDelta o )
+    {
+        swap( *( this ), o );
+        
+        return *( this );
+    }
+    
+    const std::vector< std::string > & RefDelta::added( void ) const
+    {
+        return this->impl->_added;
+    }
+    
+    const std::vector< std::string > & RefDelta::removed( void ) const
+    {
+        return this->impl->_removed;
+    }
+    
+    const std::vector< std::string > & RefDelta::moved( void ) const
+    {
+        return this->impl->_moved;
+    }
+    
+    bool RefDelta::headChanged( void ) const
+    {
+        return this->impl->_headChanged;
+    }
+    
+    bool RefDelta::isEmpty( void ) const
+    {
+        return this->impl->_headChanged == false && this->impl->_added.size() == 0 && this->impl->_removed.size() == 0 && this->impl->_moved.size() == 0;
+    }
+    
+    bool RefDelta::affects( const std::string & name ) const
+    {
+        for( const auto & names: { &( this->impl->_added ), &( this->impl->_removed ), &( this->impl->_moved ) } )
+        {
+            if( std::binary_search( names->begin(), names->end(), name ) )
+            {
+                return true;
+            }
+        }
+        
+        return false;
+    }
+    
+    void swap( RefDelta & o1, RefDelta & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    RefDelta::IMPL::IMPL( void ):
+        _headChanged( false )
+    {}
+    
+    RefDelta::IMPL::IMPL( const std::map< std::string, git_oid > & previous, const std::map< std::string, git_oid > & current, const std::string & previousHead, const std::string & currentHead ):
+        _headChanged( previousHead != currentHead )
+    {
+        auto p( previous.begin() );
+        auto c( current.begin() );
+        
+        /* Both snapshots are sorted by name, so they are compared in a single pass */
+        while( p != previous.end() || c != current.end() )
+        {
+            if( c == current.end() || ( p != previous.end() && p->first < c->first ) )
+            {
+                this->_removed.push_back( ( p++ )->first );
+            }
+            else if( p == previous.end() || c->first < p->first )
+            {
+                this->_added.push_back( ( c++ )->first );
+            }
+            else
+            {
+                if( git_oid_equal( &( p->second ), &( c->second ) ) == 0 )
+                {
+                    this->_moved.push_back( c->first );
+                    
+                    if( c->first == currentHead )
+                    {
+                        this->_headChanged = true;
+                    }
+                }
+                
+                p++;
+                c++;
+            }
+        }
+    }
+    
+    RefDelta::IMPL::IMPL( const IMPL & o ):
+        _added( o._added ),
+        _removed( o._removed ),
+        _moved( o._moved ),
+        _headChanged( o._headChanged )
+    {}
+    
+    RefDelta::IMPL::~IMPL( void )
+    {}
+}
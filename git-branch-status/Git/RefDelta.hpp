@@ -0,0 +1,70 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @header      RefDelta.hpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef GIT_REF_DELTA_HPP
+#define GIT_REF_DELTA_HPP
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <git2.h>
+
+namespace Git
+{
+    class RefDelta
+    {
+        public:
+            
+            RefDelta( void );
+            RefDelta( const std::map< std::string, git_oid > & previous, const std::map< std::string, git_oid > & current, const std::string & previousHead, const std::string & currentHead );
+            RefDelta( const RefDelta & o );
+            ~RefDelta( void );
+            
+            RefDelta & operator =( RefDelta o );
+            
+            const std::vector< std::string > & added( void )                       const;
+            const std::vector< std::string > & removed( void )                     const;
+            const std::vector< std::string > & moved( void )                       const;
+            bool                               headChanged( void )                 const;
+            bool                               isEmpty( void )                     const;
+            bool                               affects( const std::string & name ) const;
+            
+            friend void swap( RefDelta & o1, RefDelta & o2 );
+            
+        private:
+            
+            class IMPL;
+            
+            std::shared_ptr< IMPL > impl;
+    };
+}
+
+#endif /* GIT_REF_DELTA_HPP */
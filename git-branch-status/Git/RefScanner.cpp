@@ -0,0 +1,672 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @file        RefScanner.cpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <fnmatch.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "RefScanner.hpp"
+#include "Reftable.hpp"
+
+namespace Git
+{
+    class RefScanner::IMPL
+    {
+        public:
+            
+            class Ref
+            {
+                public:
+                    
+                    git_oid          _oid;
+                    std::string_view _name;
+                    bool             _remote;
+            };
+            
+            static constexpr const char * heads   = "refs/heads/";
+            static constexpr const char * remotes = "refs/remotes/";
+            
+            IMPL( git_repository * repos, const std::vector< std::string > & includes, const std::vector< std::string > & excludes );
+            ~IMPL( void );
+            
+            bool accepts( std::string_view name ) const;
+            bool matches( const std::string & pattern, std::string_view name ) const;
+            bool map( void );
+            void unmap( void );
+            void packed( void );
+            void loose( const std::string & name, std::vector< std::pair< std::string_view, std::string > > & symbolic );
+            void reftable( std::vector< std::pair< std::string_view, std::string > > & symbolic );
+            void add( const std::string & name, const git_oid * oid, const std::string & target, std::vector< std::pair< std::string_view, std::string > > & symbolic );
+            bool read( const std::string & path, std::string & contents );
+            
+            git_repository                            * _repos;
+            std::vector< std::string >                  _includes;
+            std::vector< std::string >                  _excludes;
+            std::string                                 _commonDirectory;
+            std::string                                 _gitDirectory;
+            const char                                * _data;
+            size_t                                      _size;
+            ino_t                                       _inode;
+            time_t                                      _time;
+            std::vector< Ref >                          _packed;
+            std::deque< std::string >                   _names;
+            std::vector< Ref >                          _refs;
+            std::vector< size_t >                       _sorted;
+            std::string                                 _head;
+            std::unique_ptr< Reftable >                 _reftable;
+            std::unique_ptr< Reftable >                 _worktreeReftable;
+    };
+    
+    RefScanner::RefScanner( git_repository * repos ): impl( std::make_shared< IMPL >( repos, std::vector< std::string >(), std::vector< std::string >() ) )
+    {}
+    
+    RefScanner::RefScanner( git_repository * repos, const std::vector< std::string > & includes, const std::vector< std::string > & excludes ): impl( std::make_shared< IMPL >( repos, includes, excludes ) )
+    {}
+    
+    RefScanner::~RefScanner( void )
+    {}
+    
+    void RefScanner::scan( void )
+    {
+        std::vector< std::pair< std::string_view, std::string > > symbolic;
+        std::unordered_set< std::string_view >                    names;
+        
+        this->impl->_names.clear();
+        this->impl->_refs.clear();
+        this->impl->_sorted.clear();
+        this->impl->_head.clear();
+        
+        /* Repositories using reftable keep HEAD in the table of their worktree */
+        if( this->impl->_reftable != nullptr && this->impl->_reftable->load() )
+        {
+            Reftable & worktree( ( this->impl->_worktreeReftable != nullptr && this->impl->_worktreeReftable->load() ) ? *( this->impl->_worktreeReftable ) : *( this->impl->_reftable ) );
+            
+            worktree.scan
+            (
+                "HEAD",
+                [ & ]( const std::string & name, const git_oid * oid, const std::string & target )
+                {
+                    if( name == "HEAD" && oid == nullptr )
+                    {
+                        this->impl->_head = target;
+                    }
+                }
+            );
+            
+            this->impl->reftable( symbolic );
+        }
+        else
+        {
+            std::string contents;
+            
+            if( this->impl->read( this->impl->_gitDirectory + "HEAD", contents ) && contents.compare( 0, 5, "ref: " ) == 0 )
+            {
+                this->impl->_head = contents.substr( 5 );
+            }
+            
+            if( this->impl->map() )
+            {
+                this->impl->packed();
+            }
+            
+            /* Loose refs come first, as they override packed ones */
+            this->impl->loose( IMPL::heads, symbolic );
+            this->impl->loose( IMPL::remotes, symbolic );
+            
+            for( const auto & ref: this->impl->_refs )
+            {
+                names.insert( ref._name );
+            }
+            
+            for( const auto & ref: this->impl->_packed )
+            {
+                if( names.count( ref._name ) == 0 && this->impl->accepts( ref._name ) )
+                {
+                    this->impl->_refs.push_back( ref );
+                }
+            }
+        }
+        
+        /*
+         * Symbolic refs, like origin/HEAD, take the target of the ref they
+         * point to, which is only looked up if it was filtered out.
+         */
+        if( symbolic.size() > 0 )
+        {
+            std::unordered_map< std::string_view, size_t > index;
+            
+            for( size_t i = 0; i < this->impl->_refs.size(); i++ )
+            {
+                index[ this->impl->_refs[ i ]._name ] = i;
+            }
+            
+            for( const auto & p: symbolic )
+            {
+                auto      it( index.find( p.second ) );
+                IMPL::Ref ref;
+                
+                if( it != index.end() )
+                {
+                    git_oid_cpy( &( ref._oid ), &( this->impl->_refs[ it->second ]._oid ) );
+                }
+                else if( git_reference_name_to_id( &( ref._oid ), this->impl->_repos, p.second.c_str() ) != 0 )
+                {
+                    continue;
+                }
+                
+                ref._name   = p.first;
+                ref._remote = p.first.compare( 0, strlen( IMPL::remotes ), IMPL::remotes ) == 0;
+                
+                this->impl->_refs.push_back( ref );
+            }
+        }
+        
+        for( size_t i = 0; i < this->impl->_refs.size(); i++ )
+        {
+            this->impl->_sorted.push_back( i );
+        }
+        
+        std::sort
+        (
+            this->impl->_sorted.begin(),
+            this->impl->_sorted.end(),
+            [ & ]( size_t a, size_t b )
+            {
+                return this->impl->_refs[ a ]._name < this->impl->_refs[ b ]._name;
+            }
+        );
+    }
+    
+    size_t RefScanner::count( void ) const
+    {
+        return this->impl->_refs.size();
+    }
+    
+    std::string_view RefScanner::name( size_t index ) const
+    {
+        return this->impl->_refs[ index ]._name;
+    }
+    
+    std::string_view RefScanner::shortName( size_t index ) const
+    {
+        std::string_view name( this->impl->_refs[ index ]._name );
+        
+        return name.substr( strlen( ( this->impl->_refs[ index ]._remote ) ? IMPL::remotes : IMPL::heads ) );
+    }
+    
+    const git_oid & RefScanner::oid( size_t index ) const
+    {
+        return this->impl->_refs[ index ]._oid;
+    }
+    
+    bool RefScanner::isRemote( size_t index ) const
+    {
+        return this->impl->_refs[ index ]._remote;
+    }
+    
+    bool RefScanner::find( std::string_view name, size_t & index ) const
+    {
+        auto it
+        (
+            std::lower_bound
+            (
+                this->impl->_sorted.begin(),
+                this->impl->_sorted.end(),
+                name,
+                [ & ]( size_t i, std::string_view n )
+                {
+                    return this->impl->_refs[ i ]._name < n;
+                }
+            )
+        );
+        
+        if( it == this->impl->_sorted.end() || this->impl->_refs[ *( it ) ]._name != name )
+        {
+            return false;
+        }
+        
+        index = *( it );
+        
+        return true;
+    }
+    
+    std::string_view RefScanner::head( void ) const
+    {
+        return this->impl->_head;
+    }
+    
+    bool RefScanner::readHead( const std::string & gitDirectory, std::string & ref, git_oid & oid ) const
+    {
+        std::string directory( gitDirectory );
+        std::string contents;
+        
+        ref.clear();
+        
+        if( directory.size() > 0 && directory.back() != '/' )
+        {
+            directory += "/";
+        }
+        
+        if( Reftable::exists( directory + "reftable" ) )
+        {
+            Reftable table( directory + "reftable" );
+            bool     found( false );
+            
+            if( table.load() )
+            {
+                table.scan
+                (
+                    "HEAD",
+                    [ & ]( const std::string & name, const git_oid * target, const std::string & symbolic )
+                    {
+                        if( name != "HEAD" )
+                        {
+                            return;
+                        }
+                        
+                        found = true;
+                        
+                        if( target == nullptr )
+                        {
+                            ref = symbolic;
+                        }
+                        else
+                        {
+                            git_oid_cpy( &oid, target );
+                        }
+                    }
+                );
+            }
+            
+            return found;
+        }
+        
+        if( this->impl->read( directory + "HEAD", contents ) == false )
+        {
+            return false;
+        }
+        
+        if( contents.compare( 0, 5, "ref: " ) == 0 )
+        {
+            ref = contents.substr( 5 );
+            
+            return true;
+        }
+        
+        return contents.size() >= GIT_OID_HEXSZ && git_oid_fromstrn( &oid, contents.c_str(), GIT_OID_HEXSZ ) == 0;
+    }
+    
+    RefScanner::IMPL::IMPL( git_repository * repos, const std::vector< std::string > & includes, const std::vector< std::string > & excludes ):
+        _repos( repos ),
+        _includes( includes ),
+        _excludes( excludes ),
+        _commonDirectory( git_repository_commondir( repos ) ),
+        _gitDirectory( git_repository_path( repos ) ),
+        _data( nullptr ),
+        _size( 0 ),
+        _inode( 0 ),
+        _time( 0 )
+    {
+        if( this->_commonDirectory.size() > 0 && this->_commonDirectory.back() != '/' )
+        {
+            this->_commonDirectory += "/";
+        }
+        
+        if( this->_gitDirectory.size() > 0 && this->_gitDirectory.back() != '/' )
+        {
+            this->_gitDirectory += "/";
+        }
+        
+        if( Reftable::exists( this->_commonDirectory + "reftable" ) )
+        {
+            this->_reftable = std::make_unique< Reftable >( this->_commonDirectory + "reftable" );
+            
+            if( this->_gitDirectory != this->_commonDirectory && Reftable::exists( this->_gitDirectory + "reftable" ) )
+            {
+                this->_worktreeReftable = std::make_unique< Reftable >( this->_gitDirectory + "reftable" );
+            }
+        }
+    }
+    
+    RefScanner::IMPL::~IMPL( void )
+    {
+        this->unmap();
+    }
+    
+    bool RefScanner::IMPL::accepts( std::string_view name ) const
+    {
+        bool included( this->_includes.size() == 0 );
+        
+        if( name == this->_head )
+        {
+            return true;
+        }
+        
+        for( const auto & pattern: this->_includes )
+        {
+            if( this->matches( pattern, name ) )
+            {
+                included = true;
+                
+                break;
+            }
+        }
+        
+        if( included == false )
+        {
+            return false;
+        }
+        
+        for( const auto & pattern: this->_excludes )
+        {
+            if( this->matches( pattern, name ) )
+            {
+                return false;
+            }
+        }
+        
+        return true;
+    }
+    
+    bool RefScanner::IMPL::matches( const std::string & pattern, std::string_view name ) const
+    {
+        std::string full( name );
+        
+        if( pattern.compare( 0, 5, "refs/" ) == 0 )
+        {
+            return fnmatch( pattern.c_str(), full.c_str(), 0 ) == 0;
+        }
+        
+        for( const char * prefix: { heads, remotes } )
+        {
+            if( full.compare( 0, strlen( prefix ), prefix ) == 0 )
+            {
+                return fnmatch( pattern.c_str(), full.c_str() + strlen( prefix ), 0 ) == 0;
+            }
+        }
+        
+        return false;
+    }
+    
+    bool RefScanner::IMPL::map( void )
+    {
+        std::string path( this->_commonDirectory + "packed-refs" );
+        struct stat st;
+        int         fd( -1 );
+        
+        memset( &st, 0, sizeof( struct stat ) );
+        
+        if( stat( path.c_str(), &st ) != 0 || st.st_size == 0 )
+        {
+            this->unmap();
+            
+            return false;
+        }
+        
+        /* The mapping is kept as long as the file isn't replaced */
+        if( this->_data != nullptr && st.st_ino == this->_inode && st.st_mtime == this->_time && static_cast< size_t >( st.st_size ) == this->_size )
+        {
+            return false;
+        }
+        
+        this->unmap();
+        
+        fd = open( path.c_str(), O_RDONLY );
+        
+        if( fd < 0 )
+        {
+            return false;
+        }
+        
+        {
+            void * data( mmap( nullptr, static_cast< size_t >( st.st_size ), PROT_READ, MAP_PRIVATE, fd, 0 ) );
+            
+            close( fd );
+            
+            if( data == MAP_FAILED )
+            {
+                return false;
+            }
+            
+            this->_data  = static_cast< const char * >( data );
+            this->_size  = static_cast< size_t >( st.st_size );
+            this->_inode = st.st_ino;
+            this->_time  = st.st_mtime;
+        }
+        
+        return true;
+    }
+    
+    void RefScanner::IMPL::unmap( void )
+    {
+        if( this->_data != nullptr )
+        {
+            munmap( const_cast< char * >( this->_data ), this->_size );
+        }
+        
+        this->_data  = nullptr;
+        this->_size  = 0;
+        this->_inode = 0;
+        this->_time  = 0;
+        
+        this->_packed.clear();
+    }
+    
+    void RefScanner::IMPL::packed( void )
+    {
+        const char * p( this->_data );
+        const char * end( this->_data + this->_size );
+        size_t       headsLength( strlen( heads ) );
+        size_t       remotesLength( strlen( remotes ) );
+        
+        this->_packed.clear();
+        
+        /*
+         * Lines are "<hex oid> <name>", with '#' for the header and '^' for
+         * peeled tags. Line ends are found with memchr, which libc vectorizes.
+         */
+        while( p < end )
+        {
+            const char * eol( static_cast< const char * >( memchr( p, '\n', static_cast< size_t >( end - p ) ) ) );
+            const char * name( p + GIT_OID_HEXSZ + 1 );
+            
+            if( eol == nullptr )
+            {
+                eol = end;
+            }
+            
+            if( *( p ) != '#' && *( p ) != '^' && name < eol && p[ GIT_OID_HEXSZ ] == ' ' )
+            {
+                std::string_view view( name, static_cast< size_t >( eol - name ) );
+                Ref              ref;
+                
+                ref._remote = view.compare( 0, remotesLength, remotes ) == 0;
+                
+                if( ( ref._remote || view.compare( 0, headsLength, heads ) == 0 ) && git_oid_fromstrn( &( ref._oid ), p, GIT_OID_HEXSZ ) == 0 )
+                {
+                    ref._name = view;
+                    
+                    this->_packed.push_back( ref );
+                }
+            }
+            
+            p = eol + 1;
+        }
+    }
+    
+    void RefScanner::IMPL::loose( const std::string & name, std::vector< std::pair< std::string_view, std::string > > & symbolic )
+    {
+        DIR           * dir( opendir( ( this->_commonDirectory + name ).c_str() ) );
+        struct dirent * entry( nullptr );
+        std::string     contents;
+        
+        if( dir == nullptr )
+        {
+            return;
+        }
+        
+        while( ( entry = readdir( dir ) ) != nullptr )
+        {
+            std::string child( name + entry->d_name );
+            bool        directory( entry->d_type == DT_DIR );
+            
+            if( entry->d_name[ 0 ] == '.' )
+            {
+                continue;
+            }
+            
+            if( entry->d_type == DT_UNKNOWN )
+            {
+                struct stat st;
+                
+                if( stat( ( this->_commonDirectory + child ).c_str(), &st ) != 0 )
+                {
+                    continue;
+                }
+                
+                directory = S_ISDIR( st.st_mode );
+            }
+            
+            if( directory )
+            {
+                this->loose( child + "/", symbolic );
+                
+                continue;
+            }
+            
+            if( child.size() > 5 && child.compare( child.size() - 5, 5, ".lock" ) == 0 )
+            {
+                continue;
+            }
+            
+            if( this->accepts( child ) == false || this->read( this->_commonDirectory + child, contents ) == false )
+            {
+                continue;
+            }
+            
+            if( contents.compare( 0, 5, "ref: " ) == 0 )
+            {
+                this->add( child, nullptr, contents.substr( 5 ), symbolic );
+            }
+            else
+            {
+                git_oid oid;
+                
+                if( contents.size() < GIT_OID_HEXSZ || git_oid_fromstrn( &oid, contents.c_str(), GIT_OID_HEXSZ ) != 0 )
+                {
+                    continue;
+                }
+                
+                this->add( child, &oid, "", symbolic );
+            }
+        }
+        
+        closedir( dir );
+    }
+    
+    void RefScanner::IMPL::reftable( std::vector< std::pair< std::string_view, std::string > > & symbolic )
+    {
+        for( const char * prefix: { heads, remotes } )
+        {
+            this->_reftable->scan
+            (
+                prefix,
+                [ & ]( const std::string & name, const git_oid * oid, const std::string & target )
+                {
+                    if( this->accepts( name ) )
+                    {
+                        this->add( name, oid, target, symbolic );
+                    }
+                }
+            );
+        }
+    }
+    
+    void RefScanner::IMPL::add( const std::string & name, const git_oid * oid, const std::string & target, std::vector< std::pair< std::string_view, std::string > > & symbolic )
+    {
+        this->_names.push_back( name );
+        
+        if( oid == nullptr )
+        {
+            symbolic.push_back( { this->_names.back(), target } );
+        }
+        else
+        {
+            Ref ref;
+            
+            git_oid_cpy( &( ref._oid ), oid );
+            
+            ref._name   = this->_names.back();
+            ref._remote = name.compare( 0, strlen( remotes ), remotes ) == 0;
+            
+            this->_refs.push_back( ref );
+        }
+    }
+    
+    bool RefScanner::IMPL::read( const std::string & path, std::string & contents )
+    {
+        char    buffer[ 512 ];
+        int     fd( open( path.c_str(), O_RDONLY ) );
+        ssize_t length( 0 );
+        
+        contents.clear();
+        
+        if( fd < 0 )
+        {
+            return false;
+        }
+        
+        length = ::read( fd, buffer, sizeof( buffer ) );
+        
+        close( fd );
+        
+        if( length <= 0 )
+        {
+            return false;
+        }
+        
+        contents.assign( buffer, static_cast< size_t >( length ) );
+        
+        while( contents.size() > 0 && ( contents.back() == '\n' || contents.back() == '\r' ) )
+        {
+            contents.pop_back();
+        }
+        
+        return true;
+    }
+}
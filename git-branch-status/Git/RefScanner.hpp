@@ -0,0 +1,79 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @header      RefScanner.hpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef GIT_REF_SCANNER_HPP
+#define GIT_REF_SCANNER_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <git2.h>
+
+namespace Git
+{
+    /*
+     * Lists branch references straight from the packed-refs file and the
+     * loose refs directories, without allocating a git_reference per ref.
+     * Names are views into the scanner's storage, valid until the next scan.
+     * Refs may be filtered with glob patterns, matched against full names, or
+     * short names for patterns not starting with "refs/". HEAD is always kept.
+     * Refs are also indexed by name, so a full name can be found without a
+     * linear search.
+     */
+    class RefScanner
+    {
+        public:
+            
+            RefScanner( git_repository * repos );
+            RefScanner( git_repository * repos, const std::vector< std::string > & includes, const std::vector< std::string > & excludes );
+            RefScanner( const RefScanner & o ) = delete;
+            ~RefScanner( void );
+            
+            RefScanner & operator =( const RefScanner & o ) = delete;
+            
+            void             scan( void );
+            size_t           count( void )                                                                  const;
+            std::string_view name( size_t index )                                                           const;
+            std::string_view shortName( size_t index )                                                      const;
+            const git_oid  & oid( size_t index )                                                            const;
+            bool             isRemote( size_t index )                                                       const;
+            bool             find( std::string_view name, size_t & index )                                  const;
+            std::string_view head( void )                                                                   const;
+            bool             readHead( const std::string & gitDirectory, std::string & ref, git_oid & oid ) const;
+            
+        private:
+            
+            class IMPL;
+            
+            std::shared_ptr< IMPL > impl;
+    };
+}
+
+#endif /* GIT_REF_SCANNER_HPP */
@@ -0,0 +1,660 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @file        Reftable.cpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include <stdexcept>
+#include <cstring>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "Reftable.hpp"
+
+/*
+ * Reader for the reftable ref storage (version 1 and 2, SHA-1 only).
+ * Tables are listed oldest first in tables.list, and newer tables override
+ * older ones. Each table holds sorted, prefix-compressed ref records in
+ * blocks, with restart points allowing a binary search within a block, and
+ * an optional index giving the last ref of each block, so a prefix scan
+ * only reads the blocks that may hold matching refs.
+ */
+
+namespace Git
+{
+    class Reftable::IMPL
+    {
+        public:
+            
+            class Table
+            {
+                public:
+                    
+                    Table( void );
+                    Table( const Table & o ) = delete;
+                    ~Table( void );
+                    
+                    Table & operator =( const Table & o ) = delete;
+                    
+                    bool load( const std::string & path );
+                    
+                    const uint8_t * _data;
+                    size_t          _size;
+                    size_t          _blockSize;
+                    size_t          _headerSize;
+                    size_t          _refEnd;
+                    uint64_t        _refIndex;
+            };
+            
+            class Block
+            {
+                public:
+                    
+                    bool load( const Table & table, size_t position );
+                    
+                    const uint8_t * _data;
+                    uint8_t         _type;
+                    size_t          _start;
+                    size_t          _restarts;
+                    size_t          _restartCount;
+                    size_t          _next;
+            };
+            
+            class Record
+            {
+                public:
+                    
+                    std::string _name;
+                    uint8_t     _type;
+                    git_oid     _oid;
+                    std::string _target;
+            };
+            
+            static uint32_t read24( const uint8_t * p );
+            static uint32_t read32( const uint8_t * p );
+            static uint64_t read64( const uint8_t * p );
+            static bool     varint( const Block & block, size_t & offset, uint64_t & value );
+            static bool     key( const Block & block, size_t & offset, std::string & name, uint8_t & type );
+            static bool     ref( const Block & block, size_t & offset, Record & record );
+            static size_t   restart( const Block & block, const std::string & prefix );
+            
+            IMPL( const std::string & directory );
+            
+            size_t seek( const Table & table, const std::string & prefix )                                                 const;
+            void   scan( const Table & table, const std::string & prefix, const std::function< void( Record & ) > & callback ) const;
+            
+            std::string                             _directory;
+            ino_t                                   _inode;
+            time_t                                  _time;
+            off_t                                   _size;
+            std::vector< std::string >              _names;
+            std::vector< std::shared_ptr< Table > > _tables;
+    };
+    
+    bool Reftable::exists( const std::string & directory )
+    {
+        struct stat st;
+        
+        return stat( ( directory + "/tables.list" ).c_str(), &st ) == 0 && S_ISREG( st.st_mode );
+    }
+    
+    Reftable::Reftable( const std::string & directory ): impl( std::make_shared< IMPL >( directory ) )
+    {}
+    
+    Reftable::~Reftable( void )
+    {}
+    
+    std::string Reftable::directory( void ) const
+    {
+        return this->impl->_directory;
+    }
+    
+    bool Reftable::load( void )
+    {
+        std::string path( this->impl->_directory + "/tables.list" );
+        struct stat st;
+        
+        /* Tables never change once written, so they are only mapped again when the stack does */
+        for( int attempt = 0; attempt < 3; attempt++ )
+        {
+            std::vector< std::string >                    names;
+            std::vector< std::shared_ptr< IMPL::Table > > tables;
+            bool                                          loaded( true );
+            
+            if( stat( path.c_str(), &st ) != 0 )
+            {
+                break;
+            }
+            
+            if( this->impl->_tables.size() > 0 && st.st_ino == this->impl->_inode && st.st_mtime == this->impl->_time && st.st_size == this->impl->_size )
+            {
+                return true;
+            }
+            
+            {
+                std::ifstream stream( path );
+                std::string   line;
+                
+                while( std::getline( stream, line ) )
+                {
+                    if( line.length() > 0 )
+                    {
+                        names.push_back( line );
+                    }
+                }
+            }
+            
+            /* Newest tables come first, so their refs are seen first */
+            for( auto it = names.rbegin(); it != names.rend(); ++it )
+            {
+                std::shared_ptr< IMPL::Table > table;
+                
+                for( size_t i = 0; i < this->impl->_names.size(); i++ )
+                {
+                    if( this->impl->_names[ i ] == *( it ) )
+                    {
+                        table = this->impl->_tables[ i ];
+                    }
+                }
+                
+                if( table == nullptr )
+                {
+                    table = std::make_shared< IMPL::Table >();
+                    
+                    if( table->load( this->impl->_directory + "/" + *( it ) ) == false )
+                    {
+                        /* The stack was compacted while it was read */
+                        loaded = false;
+                        
+                        break;
+                    }
+                }
+                
+                tables.push_back( table );
+            }
+            
+            if( loaded )
+            {
+                this->impl->_inode  = st.st_ino;
+                this->impl->_time   = st.st_mtime;
+                this->impl->_size   = st.st_size;
+                this->impl->_names  = std::vector< std::string >( names.rbegin(), names.rend() );
+                this->impl->_tables = tables;
+                
+                return true;
+            }
+        }
+        
+        this->impl->_names.clear();
+        this->impl->_tables.clear();
+        
+        return false;
+    }
+    
+    void Reftable::scan( const std::string & prefix, const std::function< void( const std::string & name, const git_oid * oid, const std::string & target ) > & callback ) const
+    {
+        std::function< void( IMPL::Record & ) > report
+        (
+            [ & ]( IMPL::Record & record )
+            {
+                if( record._type == 3 )
+                {
+                    callback( record._name, nullptr, record._target );
+                }
+                else if( record._type != 0 )
+                {
+                    callback( record._name, &( record._oid ), record._target );
+                }
+            }
+        );
+        
+        if( this->impl->_tables.size() == 1 )
+        {
+            this->impl->scan( *( this->impl->_tables.front() ), prefix, report );
+            
+            return;
+        }
+        
+        /* Deletions are kept while merging, as they hide the refs of older tables */
+        {
+            std::map< std::string, IMPL::Record > records;
+            
+            for( const auto & table: this->impl->_tables )
+            {
+                this->impl->scan
+                (
+                    *( table ),
+                    prefix,
+                    [ & ]( IMPL::Record & record )
+                    {
+                        if( records.count( record._name ) == 0 )
+                        {
+                            records[ record._name ] = record;
+                        }
+                    }
+                );
+            }
+            
+            for( auto & p: records )
+            {
+                report( p.second );
+            }
+        }
+    }
+    
+    uint32_t Reftable::IMPL::read24( const uint8_t * p )
+    {
+        return ( static_cast< uint32_t >( p[ 0 ] ) << 16 )
+             | ( static_cast< uint32_t >( p[ 1 ] ) <<  8 )
+             |   static_cast< uint32_t >( p[ 2 ] );
+    }
+    
+    uint32_t Reftable::IMPL::read32( const uint8_t * p )
+    {
+        return ( static_cast< uint32_t >( p[ 0 ] ) << 24 )
+             | ( static_cast< uint32_t >( p[ 1 ] ) << 16 )
+             | ( static_cast< uint32_t >( p[ 2 ] ) <<  8 )
+             |   static_cast< uint32_t >( p[ 3 ] );
+    }
+    
+    uint64_t Reftable::IMPL::read64( const uint8_t * p )
+    {
+        return ( static_cast< uint64_t >( read32( p ) ) << 32 ) | read32( p + 4 );
+    }
+    
+    bool Reftable::IMPL::varint( const Block & block, size_t & offset, uint64_t & value )
+    {
+        if( offset >= block._restarts )
+        {
+            return false;
+        }
+        
+        value = block._data[ offset ] & 0x7F;
+        
+        while( block._data[ offset++ ] & 0x80 )
+        {
+            if( offset >= block._restarts )
+            {
+                return false;
+            }
+            
+            value = ( ( value + 1 ) << 7 ) | ( block._data[ offset ] & 0x7F );
+        }
+        
+        return true;
+    }
+    
+    bool Reftable::IMPL::key( const Block & block, size_t & offset, std::string & name, uint8_t & type )
+    {
+        uint64_t prefix( 0 );
+        uint64_t suffix( 0 );
+        
+        if( varint( block, offset, prefix ) == false || varint( block, offset, suffix ) == false )
+        {
+            return false;
+        }
+        
+        type     = static_cast< uint8_t >( suffix & 0x07 );
+        suffix >>= 3;
+        
+        if( prefix > name.length() || suffix > block._restarts - offset )
+        {
+            return false;
+        }
+        
+        name.resize( static_cast< size_t >( prefix ) );
+        name.append( reinterpret_cast< const char * >( block._data + offset ), static_cast< size_t >( suffix ) );
+        
+        offset += static_cast< size_t >( suffix );
+        
+        return true;
+    }
+    
+    bool Reftable::IMPL::ref( const Block & block, size_t & offset, Record & record )
+    {
+        uint64_t index( 0 );
+        
+        if( key( block, offset, record._name, record._type ) == false || varint( block, offset, index ) == false )
+        {
+            return false;
+        }
+        
+        record._target.clear();
+        
+        if( record._type == 1 || record._type == 2 )
+        {
+            size_t size( ( record._type == 1 ) ? GIT_OID_RAWSZ : GIT_OID_RAWSZ * 2 );
+            
+            if( size > block._restarts - offset )
+            {
+                return false;
+            }
+            
+            git_oid_fromraw( &( record._oid ), block._data + offset );
+            
+            offset += size;
+        }
+        else if( record._type == 3 )
+        {
+            uint64_t length( 0 );
+            
+            if( varint( block, offset, length ) == false || length > block._restarts - offset )
+            {
+                return false;
+            }
+            
+            record._target.assign( reinterpret_cast< const char * >( block._data + offset ), static_cast< size_t >( length ) );
+            
+            offset += static_cast< size_t >( length );
+        }
+        else if( record._type != 0 )
+        {
+            return false;
+        }
+        
+        return true;
+    }
+    
+    size_t Reftable::IMPL::restart( const Block & block, const std::string & prefix )
+    {
+        size_t low( 0 );
+        size_t high( block._restartCount );
+        
+        /* Restart records aren't prefix-compressed, so the last one before the prefix can be found directly */
+        while( low < high )
+        {
+            size_t      middle( low + ( high - low ) / 2 );
+            size_t      offset( read24( block._data + block._restarts + middle * 3 ) );
+            std::string name;
+            uint8_t     type( 0 );
+            
+            if( offset >= block._restarts || key( block, offset, name, type ) == false )
+            {
+                return block._start;
+            }
+            
+            if( name < prefix )
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+        
+        return ( low == 0 ) ? block._start : read24( block._data + block._restarts + ( low - 1 ) * 3 );
+    }
+    
+    Reftable::IMPL::IMPL( const std::string & directory ):
+        _directory( directory ),
+        _inode( 0 ),
+        _time( 0 ),
+        _size( 0 )
+    {}
+    
+    size_t Reftable::IMPL::seek( const Table & table, const std::string & prefix ) const
+    {
+        size_t position( static_cast< size_t >( table._refIndex ) );
+        
+        if( position == 0 )
+        {
+            return 0;
+        }
+        
+        /* Index records hold the last ref of the block they point to, so the first one not before the prefix is followed */
+        for( int level = 0; level < 8; level++ )
+        {
+            Block       block;
+            size_t      offset( 0 );
+            std::string name;
+            uint8_t     type( 0 );
+            bool        found( false );
+            
+            if( block.load( table, position ) == false )
+            {
+                return 0;
+            }
+            
+            if( block._type == 'r' )
+            {
+                return position;
+            }
+            
+            if( block._type != 'i' )
+            {
+                return 0;
+            }
+            
+            offset = restart( block, prefix );
+            
+            while( offset < block._restarts )
+            {
+                uint64_t value( 0 );
+                
+                if( key( block, offset, name, type ) == false || varint( block, offset, value ) == false )
+                {
+                    return 0;
+                }
+                
+                if( name >= prefix )
+                {
+                    position = static_cast< size_t >( value );
+                    found    = true;
+                    
+                    break;
+                }
+            }
+            
+            if( found == false )
+            {
+                return table._refEnd;
+            }
+        }
+        
+        return 0;
+    }
+    
+    void Reftable::IMPL::scan( const Table & table, const std::string & prefix, const std::function< void( Record & ) > & callback ) const
+    {
+        size_t position( this->seek( table, prefix ) );
+        bool   first( true );
+        Record record;
+        
+        while( position < table._refEnd )
+        {
+            Block  block;
+            size_t offset( 0 );
+            
+            if( block.load( table, position ) == false || block._type != 'r' )
+            {
+                break;
+            }
+            
+            offset = ( first ) ? restart( block, prefix ) : block._start;
+            first  = false;
+            
+            record._name.clear();
+            
+            while( offset < block._restarts )
+            {
+                if( ref( block, offset, record ) == false )
+                {
+                    return;
+                }
+                
+                if( record._name.compare( 0, prefix.length(), prefix ) == 0 )
+                {
+                    callback( record );
+                }
+                else if( record._name > prefix )
+                {
+                    return;
+                }
+            }
+            
+            position = block._next;
+        }
+    }
+    
+    Reftable::IMPL::Table::Table( void ):
+        _data( nullptr ),
+        _size( 0 ),
+        _blockSize( 0 ),
+        _headerSize( 0 ),
+        _refEnd( 0 ),
+        _refIndex( 0 )
+    {}
+    
+    Reftable::IMPL::Table::~Table( void )
+    {
+        if( this->_data != nullptr )
+        {
+            munmap( const_cast< uint8_t * >( this->_data ), this->_size );
+        }
+    }
+    
+    bool Reftable::IMPL::Table::load( const std::string & path )
+    {
+        int         fd( open( path.c_str(), O_RDONLY ) );
+        struct stat st;
+        
+        if( fd < 0 )
+        {
+            return false;
+        }
+        
+        if( fstat( fd, &st ) != 0 || st.st_size == 0 )
+        {
+            close( fd );
+            
+            return false;
+        }
+        
+        {
+            void * data( mmap( nullptr, static_cast< size_t >( st.st_size ), PROT_READ, MAP_PRIVATE, fd, 0 ) );
+            
+            close( fd );
+            
+            if( data == MAP_FAILED )
+            {
+                return false;
+            }
+            
+            this->_data = static_cast< const uint8_t * >( data );
+            this->_size = static_cast< size_t >( st.st_size );
+        }
+        
+        if( this->_size < 24 || memcmp( this->_data, "REFT", 4 ) != 0 )
+        {
+            throw std::runtime_error( "Invalid reftable: " + path );
+        }
+        
+        if( this->_data[ 4 ] == 2 && this->_size >= 28 && memcmp( this->_data + 24, "sha1", 4 ) == 0 )
+        {
+            this->_headerSize = 28;
+        }
+        else if( this->_data[ 4 ] == 1 )
+        {
+            this->_headerSize = 24;
+        }
+        else
+        {
+            throw std::runtime_error( "Unsupported reftable version or hash: " + path );
+        }
+        
+        this->_blockSize = read24( this->_data + 5 );
+        
+        /* The footer repeats the header, followed by the section positions and a CRC */
+        {
+            size_t          footerSize( this->_headerSize + 44 );
+            const uint8_t * footer( nullptr );
+            
+            if( this->_size < this->_headerSize + footerSize )
+            {
+                throw std::runtime_error( "Invalid reftable: " + path );
+            }
+            
+            footer          = this->_data + this->_size - footerSize;
+            this->_refEnd   = this->_size - footerSize;
+            this->_refIndex = read64( footer + this->_headerSize );
+            
+            for( uint64_t position: { this->_refIndex, read64( footer + this->_headerSize + 8 ) >> 5, read64( footer + this->_headerSize + 16 ), read64( footer + this->_headerSize + 24 ) } )
+            {
+                if( position > 0 && position < this->_refEnd )
+                {
+                    this->_refEnd = static_cast< size_t >( position );
+                }
+            }
+        }
+        
+        return true;
+    }
+    
+    bool Reftable::IMPL::Block::load( const Table & table, size_t position )
+    {
+        /* The first block starts with the file header, which counts in its length */
+        size_t header( ( position == 0 ) ? table._headerSize : 0 );
+        size_t length( 0 );
+        
+        if( position + header + 4 > table._size )
+        {
+            return false;
+        }
+        
+        this->_data  = table._data + position;
+        this->_type  = this->_data[ header ];
+        this->_start = header + 4;
+        length       = read24( this->_data + header + 1 );
+        
+        if( length < this->_start + 2 || position + length > table._size )
+        {
+            return false;
+        }
+        
+        this->_restartCount = ( static_cast< size_t >( this->_data[ length - 2 ] ) << 8 ) | this->_data[ length - 1 ];
+        
+        if( this->_restartCount * 3 + 2 > length - this->_start )
+        {
+            return false;
+        }
+        
+        this->_restarts = length - 2 - this->_restartCount * 3;
+        this->_next     = position + length;
+        
+        /* Blocks may be padded with zeros up to the block size */
+        if( table._blockSize > 0 && this->_next % table._blockSize != 0 && this->_next < table._size && table._data[ this->_next ] == 0 )
+        {
+            this->_next += table._blockSize - this->_next % table._blockSize;
+        }
+        
+        return true;
+    }
+}
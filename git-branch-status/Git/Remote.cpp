@@ -80,14 +80,14 @@ namespace Git
         return !operator ==( o );
     }
     
-    std::string Remote::name( void ) const
+    std::string_view Remote::name( void ) const
     {
         const char * s( git_remote_name( this->impl->_remote ) );
         
         return ( s == nullptr ) ? "" : s;
     }
     
-    std::string Remote::url(  void ) const
+    std::string_view Remote::url(  void ) const
     {
         const char * s( git_remote_url( this->impl->_remote ) );
         
@@ -96,46 +96,29 @@ namespace Git
     
     bool Remote::fetch( const std::vector< std::string > & refspecs, const std::string & reflogMessage ) const
     {
-        git_strarray      array;
-        int               status;
-        git_fetch_options options = GIT_FETCH_OPTIONS_INIT;
-        
-        memset( &array, 0, sizeof( git_strarray ) );
+        git_strarray               array;
+        std::vector< std::string > copies( refspecs );
+        std::vector< char * >      strings;
+        git_fetch_options          options = GIT_FETCH_OPTIONS_INIT;
         
         options.callbacks.credentials = IMPL::credentials;
         
-        if( refspecs.size() > 0 )
+        /* The array only borrows the copies, which own the strings */
+        for( auto & copy: copies )
         {
-            array.count   = refspecs.size();
-            array.strings = new char *[ refspecs.size() ];
-            
-            for( size_t i = 0; i < refspecs.size(); i++ )
-            {
-                array.strings[ i ] = new char[ refspecs[ i ].length() + 1 ];
-                
-                strcpy( array.strings[ i ], refspecs[ i ].c_str() );
-            }
+            strings.push_back( &( copy[ 0 ] ) );
         }
         
-        status = git_remote_fetch
+        array.count   = strings.size();
+        array.strings = strings.data();
+        
+        return git_remote_fetch
         (
             this->impl->_remote,
             ( refspecs.size() == 0 ) ? nullptr : &array,
             &options,
             ( reflogMessage.length() == 0 ) ? nullptr : reflogMessage.c_str()
-        );
-        
-        if( refspecs.size() > 0 )
-        {
-            for( size_t i = 0; i < refspecs.size(); i++ )
-            {
-                delete [] array.strings[ i ];
-            }
-            
-            delete [] array.strings;
-        }
-        
-        return status == 0;
+        ) == 0;
     }
     
     void swap( Remote & o1, Remote & o2 )
@@ -31,6 +31,7 @@
 #define GIT_REMOTE_HPP
 
 #include <string>
+#include <string_view>
 #include <memory>
 #include <vector>
 #include <algorithm>
@@ -55,8 +56,8 @@ namespace Git
             bool operator ==( const Remote & o ) const;
             bool operator !=( const Remote & o ) const;
             
-            std::string name( void ) const;
-            std::string url(  void ) const;
+            std::string_view name( void ) const;
+            std::string_view url(  void ) const;
             
             bool fetch( const std::vector< std::string > & refspecs = {}, const std::string & reflogMessage = "" ) const;
             
@@ -28,7 +28,22 @@
  */
 
 #include <stdexcept>
+#include <cstring>
+#include <map>
+#include <set>
+#include <functional>
+#include <mutex>
+#include <tuple>
+#include <thread>
+#include <sys/stat.h>
+#include <git2/sys/repository.h>
 #include "Repository.hpp"
+#include "Graph.hpp"
+#include "RefScanner.hpp"
+#include "Reftable.hpp"
+#include "Handle.hpp"
+#include "ThreadPool.hpp"
+#include "Arguments.hpp"
 
 namespace Git
 {
@@ -36,17 +51,68 @@ namespace Git
     {
         public:
             
-            IMPL( const std::string & path );
+            class Upstreams
+            {
+                public:
+                    
+                    class Entry
+                    {
+                        public:
+                            
+                            time_t                               _time;
+                            off_t                                _size;
+                            std::map< std::string, std::string > _names;
+                    };
+                    
+                    std::map< std::string, Entry > _entries;
+                    std::mutex                     _mtx;
+            };
+            
+            IMPL( const std::string & path, History * history );
             IMPL( const IMPL & o );
             ~IMPL( void );
             
-            std::string                    _path;
-            git_repository               * _repos;
-            std::vector< git_reference * > _branches;
-            std::vector< git_remote    * > _remotes;
+            static constexpr size_t minChunkSize = 16;
+            
+            static Upstreams                                           & upstreams( void );
+            static Utility::ThreadPool                                 & submodulePool( void );
+            static std::vector< std::pair< std::string, std::string > >  submoduleNames( git_repository * repos );
+            static void                                                  watch( git_repository * repos, Utility::Watcher & watcher, size_t depth );
+            
+            void                              list( void );
+            void                              listRemotes( void );
+            void                              graph( const Repository & repos );
+            void                              upstream( const std::string & ref );
+            std::string                       upstreamName( git_config * config, const std::string & branch );
+            std::map< std::string, git_oid >  tips( std::string & head ) const;
+            git_repository                  * handle( size_t worker );
+            Utility::Optional< CommitInfo >   commit( const git_oid & oid );
+            Utility::Optional< BranchStatus > headStatus( void );
+            
+            std::string                                            _path;
+            RepositoryHandle                                       _repos;
+            std::unique_ptr< RefScanner >                          _refs;
+            std::vector< RemoteHandle >                            _remotes;
+            time_t                                                 _configTime;
+            off_t                                                  _configSize;
+            DiskCache                                            * _cache;
+            History                                              * _history;
+            std::vector< RepositoryHandle >                        _handles;
+            bool                                                   _graphed;
+            std::map< std::string, std::pair< size_t, size_t > >   _aheadBehind;
+            std::set< std::string >                                _saturated;
+            bool                                                   _upstreamed;
+            std::map< std::string, std::string >                   _upstreams;
+            std::map< std::string, std::pair< size_t, size_t > >   _upstreamCounts;
+            std::map< std::string, std::pair< git_oid, git_oid > > _upstreamPairs;
+            std::map< std::string, CommitInfo >                    _infos;
+            std::map< std::string, std::unique_ptr< Repository > > _submodules;
     };
     
-    Repository::Repository( const std::string & path ): impl( std::make_shared< IMPL >( path ) )
+    Repository::Repository( const std::string & path ): impl( std::make_shared< IMPL >( path, nullptr ) )
+    {}
+    
+    Repository::Repository( const std::string & path, History & history ): impl( std::make_shared< IMPL >( path, &history ) )
     {}
     
     Repository::Repository( const Repository & o ): impl( std::make_shared< IMPL >( *( o.impl ) ) )
@@ -85,15 +151,11 @@ namespace Git
     std::vector< Branch > Repository::branches( void ) const
     {
         std::vector< Branch > branches;
+        RefScanner          & refs( *( this->impl->_refs ) );
         
-        for( const auto & ref: this->impl->_branches )
+        for( size_t i = 0; i < refs.count(); i++ )
         {
-            try
-            {
-                branches.push_back( { ref, *( this ) } );
-            }
-            catch( ... )
-            {}
+            branches.push_back( { std::string( refs.shortName( i ) ), refs.oid( i ), refs.isRemote( i ) == false && refs.name( i ) == refs.head(), *( this ) } );
         }
         
         std::sort
@@ -128,99 +190,1281 @@ namespace Git
     
     Utility::Optional< Branch > Repository::head( void ) const
     {
-        for( const auto & b: this->branches() )
+        RefScanner & refs( *( this->impl->_refs ) );
+        
+        for( size_t i = 0; i < refs.count(); i++ )
         {
-            if( b.isHead() )
+            if( refs.isRemote( i ) == false && refs.name( i ) == refs.head() )
             {
-                return b;
+                return Branch( std::string( refs.shortName( i ) ), refs.oid( i ), true, *( this ) );
             }
         }
         
         return {};
     }
     
-    void swap( Repository & o1, Repository & o2 )
+    DiskCache & Repository::cache( void ) const
     {
-        using std::swap;
+        return *( this->impl->_cache );
+    }
+    
+    std::vector< BranchStatus > Repository::status( void ) const
+    {
+        std::vector< Branch >                          branches( this->branches() );
+        std::vector< git_oid >                         tips( branches.size() );
+        std::vector< std::unique_ptr< CommitInfo > >   infos( branches.size() );
+        std::vector< std::function< void( size_t ) > > tasks;
+        std::vector< BranchStatus >                    status;
         
-        swap( o1.impl, o2.impl );
+        if( this->impl->_graphed == false )
+        {
+            this->impl->graph( *( this ) );
+        }
+        
+        if( this->impl->_upstreamed == false && Utility::Arguments::sharedInstance().upstream() )
+        {
+            this->impl->upstream( "" );
+        }
+        
+        for( size_t i = 0; i < branches.size(); i++ )
+        {
+            Utility::Optional< git_oid > oid( branches[ i ].target() );
+            
+            if( oid.hasValue() == false )
+            {
+                continue;
+            }
+            
+            tips[ i ] = *( oid );
+            
+            {
+                auto it( this->impl->_infos.find( branches[ i ].name() ) );
+                
+                if( it != this->impl->_infos.end() && git_oid_equal( &( it->second.oid() ), &( tips[ i ] ) ) )
+                {
+                    infos[ i ] = std::make_unique< CommitInfo >( it->second );
+                    
+                    continue;
+                }
+            }
+            
+            tasks.push_back
+            (
+                [ &, i ]( size_t worker )
+                {
+                    Utility::Optional< CommitInfo > info( this->impl->_cache->commit( tips[ i ] ) );
+                    
+                    if( info.hasValue() == false )
+                    {
+                        info = CommitInfo::read( this->impl->handle( worker ), tips[ i ] );
+                        
+                        if( info.hasValue() == false )
+                        {
+                            return;
+                        }
+                        
+                        this->impl->_cache->setCommit( *( info ) );
+                    }
+                    
+                    infos[ i ] = std::make_unique< CommitInfo >( *( info ) );
+                }
+            );
+        }
+        
+        Utility::ThreadPool::shared().run( tasks );
+        
+        for( size_t i = 0; i < branches.size(); i++ )
+        {
+            Utility::Optional< CommitInfo >                  info;
+            Utility::Optional< std::pair< size_t, size_t > > counts;
+            std::string                                      upstream;
+            Utility::Optional< std::pair< size_t, size_t > > upstreamCounts;
+            
+            if( infos[ i ] != nullptr )
+            {
+                info = Utility::Optional< CommitInfo >( *( infos[ i ] ) );
+                
+                this->impl->_infos.erase( branches[ i ].name() );
+                this->impl->_infos.emplace( branches[ i ].name(), *( infos[ i ] ) );
+            }
+            
+            if( branches[ i ].isHead() == false && this->impl->_aheadBehind.count( branches[ i ].name() ) > 0 )
+            {
+                counts = Utility::Optional< std::pair< size_t, size_t > >( this->impl->_aheadBehind[ branches[ i ].name() ] );
+            }
+            
+            if( this->impl->_upstreams.count( branches[ i ].name() ) > 0 )
+            {
+                upstream       = this->impl->_upstreams[ branches[ i ].name() ];
+                upstreamCounts = Utility::Optional< std::pair< size_t, size_t > >( this->impl->_upstreamCounts[ branches[ i ].name() ] );
+            }
+            
+            status.push_back( { branches[ i ].name(), branches[ i ].isHead(), info, counts, this->impl->_saturated.count( branches[ i ].name() ) > 0, upstream, upstreamCounts } );
+        }
+        
+        return status;
     }
     
-    Repository::IMPL::IMPL( const std::string & path ):
-        _path( path ),
-        _repos( nullptr )
+    BranchSnapshot Repository::snapshot( void ) const
     {
-        git_libgit2_init();
+        return BranchSnapshot( this->status() );
+    }
+    
+    Utility::Optional< BranchStatus > Repository::headStatus( void ) const
+    {
+        return this->impl->headStatus();
+    }
+    
+    std::vector< Worktree > Repository::worktrees( const BranchSnapshot & snapshot ) const
+    {
+        std::vector< Worktree >                                          worktrees;
+        std::vector< std::tuple< std::string, std::string, std::string > > entries;
+        std::string                                                      current( git_repository_path( this->impl->_repos ) );
+        std::string                                                      common( git_repository_commondir( this->impl->_repos ) );
+        std::map< std::string_view, size_t >                             index;
+        Utility::Optional< git_oid >                                     head;
+        
+        for( std::string * directory: { &current, &common } )
+        {
+            if( directory->size() > 0 && directory->back() != '/' )
+            {
+                *( directory ) += "/";
+            }
+        }
+        
+        /* The main worktree is the parent of the common directory, unless the repository is bare */
+        if( current == common && git_repository_workdir( this->impl->_repos ) != nullptr )
+        {
+            entries.push_back( { "", git_repository_workdir( this->impl->_repos ), common } );
+        }
+        else if( current != common && common.size() > 6 && common.compare( common.size() - 6, 6, "/.git/" ) == 0 )
+        {
+            entries.push_back( { "", common.substr( 0, common.size() - 5 ), common } );
+        }
+        
+        {
+            StrArray names;
+            
+            if( git_worktree_list( names.get(), this->impl->_repos ) == 0 )
+            {
+                for( size_t i = 0; i < names->count; i++ )
+                {
+                    WorktreeHandle worktree;
+                    
+                    if( git_worktree_lookup( worktree.out(), this->impl->_repos, names->strings[ i ] ) != 0 || worktree == nullptr )
+                    {
+                        continue;
+                    }
+                    
+                    if( git_worktree_validate( worktree ) == 0 )
+                    {
+                        entries.push_back( { names->strings[ i ], git_worktree_path( worktree ), common + "worktrees/" + names->strings[ i ] + "/" } );
+                    }
+                }
+            }
+        }
+        
+        for( auto & entry: entries )
+        {
+            if( std::get< 1 >( entry ).size() > 1 && std::get< 1 >( entry ).back() == '/' )
+            {
+                std::get< 1 >( entry ).pop_back();
+            }
+        }
+        
+        for( size_t i = 0; i < this->impl->_refs->count(); i++ )
+        {
+            index[ this->impl->_refs->name( i ) ] = i;
+        }
         
+        if( snapshot.head().hasValue() && snapshot.head()->lastCommit().hasValue() )
         {
-            git_branch_iterator * it( nullptr );
+            head = Utility::Optional< git_oid >( snapshot.head()->lastCommit()->oid() );
+        }
+        
+        /*
+         * Worktrees only differ by their HEAD, as they share refs and
+         * objects. Branches come from the snapshot; detached or filtered
+         * ones are looked up here, through the same caches.
+         */
+        for( const auto & entry: entries )
+        {
+            std::string                                      ref;
+            git_oid                                          oid;
+            bool                                             found( false );
+            std::string                                      name( "(detached)" );
+            Utility::Optional< CommitInfo >                  info;
+            Utility::Optional< std::pair< size_t, size_t > > counts;
             
-            if( git_repository_open( &( this->_repos ), path.c_str() ) != 0 || this->_repos == nullptr )
+            if( this->impl->_refs->readHead( std::get< 2 >( entry ), ref, oid ) == false )
             {
-                throw std::runtime_error( "Cannot open Git repository: " + path );
+                continue;
             }
             
-            if( git_branch_iterator_new( &it, this->_repos, GIT_BRANCH_ALL ) != 0 || it == nullptr )
+            if( ref.length() > 0 )
+            {
+                auto it( index.find( ref ) );
+                
+                name = ( ref.compare( 0, 11, "refs/heads/" ) == 0 ) ? ref.substr( 11 ) : ref;
+                
+                {
+                    Utility::Optional< BranchStatus > status( snapshot.find( name ) );
+                    
+                    if( status.hasValue() )
+                    {
+                        worktrees.push_back( { std::get< 0 >( entry ), std::get< 1 >( entry ), std::get< 2 >( entry ) == current, false, *( status ) } );
+                        
+                        continue;
+                    }
+                }
+                
+                if( it != index.end() )
+                {
+                    git_oid_cpy( &oid, &( this->impl->_refs->oid( it->second ) ) );
+                    
+                    found = true;
+                }
+            }
+            else
             {
-                throw std::runtime_error( "Cannot iterate branches" );
+                found = true;
             }
             
+            if( found )
             {
-                git_reference * ref( nullptr );
-                git_branch_t    type;
+                info = this->impl->commit( oid );
                 
-                while( git_branch_next( &ref, &type, it ) == 0 )
+                if( head.hasValue() )
                 {
-                    if( ref != nullptr )
+                    counts = this->impl->_cache->aheadBehind( *( head ), oid );
+                    
+                    if( counts.hasValue() == false )
                     {
-                        this->_branches.push_back( ref );
+                        try
+                        {
+                            std::pair< size_t, size_t > computed( Graph( this->impl->_repos ).aheadBehind( *( head ), { oid } ).front() );
+                            
+                            this->impl->_cache->setAheadBehind( *( head ), oid, computed );
+                            
+                            counts = Utility::Optional< std::pair< size_t, size_t > >( computed );
+                        }
+                        catch( ... )
+                        {}
                     }
                 }
             }
             
-            git_branch_iterator_free( it );
+            worktrees.push_back( { std::get< 0 >( entry ), std::get< 1 >( entry ), std::get< 2 >( entry ) == current, ref.length() == 0, BranchStatus( name, false, info, counts, false, "", {} ) } );
+        }
+        
+        return worktrees;
+    }
+    
+    bool Repository::aheadBehind( const Branch & branch, size_t & ahead, size_t & behind ) const
+    {
+        if( this->impl->_graphed == false )
+        {
+            this->impl->graph( *( this ) );
+        }
+        
+        {
+            auto it( this->impl->_aheadBehind.find( branch.name() ) );
+            
+            if( it == this->impl->_aheadBehind.end() )
+            {
+                return false;
+            }
+            
+            ahead  = it->second.first;
+            behind = it->second.second;
         }
         
+        return true;
+    }
+    
+    std::vector< std::vector< std::pair< size_t, size_t > > > Repository::matrix( const std::vector< Branch > & branches ) const
+    {
+        std::vector< git_oid > tips;
+        
+        for( const auto & branch: branches )
         {
-            git_strarray names;
+            Utility::Optional< git_oid > oid( branch.target() );
+            
+            if( oid.hasValue() == false )
+            {
+                throw std::runtime_error( "Cannot get branch target: " + branch.name() );
+            }
             
-            memset( &names, 0, sizeof( git_strarray ) );
+            tips.push_back( *( oid ) );
+        }
+        
+        return Graph( this->impl->_repos ).matrix( tips );
+    }
+    
+    std::vector< Submodule > Repository::submodules( void ) const
+    {
+        class Node
+        {
+            public:
+                
+                std::string                                          _name;
+                std::string                                          _path;
+                size_t                                               _depth;
+                Utility::Optional< BranchStatus >                    _status;
+                std::vector< std::pair< std::string, std::string > > _found;
+                std::vector< size_t >                                _children;
+        };
+        
+        std::vector< Node >             nodes;
+        std::vector< size_t >           roots;
+        std::vector< size_t >           level;
+        std::set< std::string >         visited;
+        std::vector< Submodule >        submodules;
+        std::function< void( size_t ) > append;
+        
+        for( const auto & found: IMPL::submoduleNames( this->impl->_repos ) )
+        {
+            roots.push_back( nodes.size() );
+            level.push_back( nodes.size() );
+            nodes.push_back( { found.first, found.second, 0, {}, {}, {} } );
+        }
+        
+        /*
+         * Submodules are evaluated one nesting level at a time, each level
+         * in a single batch on a bounded pool, as opening and scanning them
+         * is mostly I/O. Their repositories are kept across calls, so later
+         * ones only refresh their refs.
+         */
+        while( level.size() > 0 )
+        {
+            std::vector< std::function< void( size_t ) > > tasks;
+            std::vector< size_t >                          next;
             
-            if( git_remote_list( &names, this->_repos ) == 0 )
+            for( size_t i: level )
             {
-                for( size_t i = 0; i < names.count; i++ )
-                {
+                std::unique_ptr< Repository > * repos( &( this->impl->_submodules[ nodes[ i ]._path ] ) );
+                
+                visited.insert( nodes[ i ]._path );
+                tasks.push_back
+                (
+                    [ &, i, repos ]( size_t )
                     {
-                        git_remote * remote( nullptr );
+                        Node & node( nodes[ i ] );
                         
-                        if( git_remote_lookup( &remote, this->_repos, names.strings[ i ] ) == 0 && remote != nullptr )
+                        try
                         {
-                            this->_remotes.push_back( remote );
+                            if( *( repos ) == nullptr )
+                            {
+                                *( repos ) = std::make_unique< Repository >( node._path );
+                            }
+                            else
+                            {
+                                ( *( repos ) )->refresh();
+                            }
+                            
+                            node._found  = IMPL::submoduleNames( ( *( repos ) )->impl->_repos );
+                            node._status = ( *( repos ) )->headStatus();
                         }
+                        catch( ... )
+                        {
+                            /* Not initialized, or with a broken HEAD or ref, so shown without a status */
+                            node._status = Utility::Optional< BranchStatus >();
+                        }
+                    }
+                );
+            }
+            
+            IMPL::submodulePool().run( tasks );
+            
+            for( size_t i: level )
+            {
+                if( nodes[ i ]._depth >= 16 )
+                {
+                    continue;
+                }
+                
+                for( const auto & found: nodes[ i ]._found )
+                {
+                    if( visited.count( found.second ) > 0 )
+                    {
+                        continue;
+                    }
+                    
+                    nodes[ i ]._children.push_back( nodes.size() );
+                    next.push_back( nodes.size() );
+                    nodes.push_back( { found.first, found.second, nodes[ i ]._depth + 1, {}, {}, {} } );
+                }
+            }
+            
+            level = next;
+        }
+        
+        /* Submodules which went away are closed */
+        for( auto it = this->impl->_submodules.begin(); it != this->impl->_submodules.end(); )
+        {
+            it = ( visited.count( it->first ) > 0 ) ? std::next( it ) : this->impl->_submodules.erase( it );
+        }
+        
+        append = [ & ]( size_t i )
+        {
+            submodules.push_back( { nodes[ i ]._name, nodes[ i ]._path, nodes[ i ]._depth, nodes[ i ]._status } );
+            
+            for( size_t child: nodes[ i ]._children )
+            {
+                append( child );
+            }
+        };
+        
+        for( size_t i: roots )
+        {
+            append( i );
+        }
+        
+        return submodules;
+    }
+    
+    RefDelta Repository::refresh( void )
+    {
+        std::string                      previousHead;
+        std::string                      currentHead;
+        std::map< std::string, git_oid > previous( this->impl->tips( previousHead ) );
+        
+        this->impl->_cache->save();
+        this->impl->list();
+        this->impl->listRemotes();
+        
+        {
+            RefDelta delta( previous, this->impl->tips( currentHead ), previousHead, currentHead );
+            
+            /*
+             * Only the counts of branches which changed are dropped, unless
+             * HEAD did, in which case all of them are computed again, in one
+             * batch. Upstreams are always resolved again, as the config may
+             * have changed, but pairs which didn't move keep their counts.
+             */
+            if( delta.headChanged() )
+            {
+                this->impl->_aheadBehind.clear();
+                this->impl->_saturated.clear();
+            }
+            else
+            {
+                for( const auto & names: { &( delta.removed() ), &( delta.moved() ) } )
+                {
+                    for( const auto & name: *( names ) )
+                    {
+                        this->impl->_aheadBehind.erase( name );
+                        this->impl->_saturated.erase( name );
                     }
                 }
             }
+            
+            for( const auto & name: delta.removed() )
+            {
+                this->impl->_infos.erase( name );
+            }
+            
+            if( delta.isEmpty() == false )
+            {
+                this->impl->_graphed = false;
+            }
+            
+            this->impl->_upstreamed = false;
+            
+            return delta;
+        }
+    }
+    
+    void Repository::watch( Utility::Watcher & watcher ) const
+    {
+        IMPL::watch( this->impl->_repos, watcher, 0 );
+    }
+    
+    void swap( Repository & o1, Repository & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    Repository::IMPL::IMPL( const std::string & path, History * history ):
+        _path( path ),
+        _configTime( 0 ),
+        _configSize( -1 ),
+        _cache( nullptr ),
+        _history( history ),
+        _handles( Utility::ThreadPool::shared().count() ),
+        _graphed( false ),
+        _upstreamed( false )
+    {
+        static std::once_flag once;
+        
+        std::call_once( once, [] { git_libgit2_init(); } );
+        
+        if( git_repository_open( this->_repos.out(), path.c_str() ) != 0 || this->_repos == nullptr )
+        {
+            throw std::runtime_error( "Cannot open Git repository: " + path );
+        }
+        
+        {
+            std::string directory( git_repository_commondir( this->_repos ) );
+            
+            while( directory.size() > 1 && directory.back() == '/' )
+            {
+                directory.pop_back();
+            }
+            
+            this->_cache = &( DiskCache::shared( directory ) );
         }
+        
+        this->list();
+        this->listRemotes();
     }
     
-    Repository::IMPL::IMPL( const IMPL & o ): IMPL( o._path )
+    Repository::IMPL::IMPL( const IMPL & o ): IMPL( o._path, o._history )
     {}
     
     Repository::IMPL::~IMPL( void )
     {
-        for( const auto & reference: this->_branches )
+        if( this->_cache != nullptr )
+        {
+            this->_cache->save();
+        }
+    }
+    
+    void Repository::IMPL::list( void )
+    {
+        /* Refs are filtered while they are scanned, so rejected ones never get a branch or a walk */
+        if( this->_refs == nullptr )
         {
-            git_reference_free( reference );
+            Utility::Arguments & args( Utility::Arguments::sharedInstance() );
+            
+            this->_refs = std::make_unique< RefScanner >( this->_repos, args.includes(), args.excludes() );
         }
         
-        for( const auto & remote: this->_remotes )
+        this->_refs->scan();
+    }
+    
+    void Repository::IMPL::listRemotes( void )
+    {
+        struct stat st;
+        
+        memset( &st, 0, sizeof( struct stat ) );
+        stat( ( std::string( git_repository_commondir( this->_repos ) ) + "/config" ).c_str(), &st );
+        
+        /* Remotes only change with the config file, so they are listed again when it does */
+        if( st.st_mtime == this->_configTime && st.st_size == this->_configSize )
         {
-            git_remote_free( remote );
+            return;
         }
         
-        if( this->_repos != nullptr )
+        this->_configTime = st.st_mtime;
+        this->_configSize = st.st_size;
+        
+        this->_remotes.clear();
+        
+        /*
+         * Remotes are the names of the remote.<name>.url and .pushurl
+         * configuration entries, as git_remote_list() finds them, but without
+         * its regular expression, which some libgit2 builds leak on each call.
+         */
         {
-            git_repository_free( this->_repos );
+            ConfigHandle            config;
+            ConfigIteratorHandle    it;
+            git_config_entry      * entry( nullptr );
+            std::set< std::string > names;
+            
+            if( git_repository_config_snapshot( config.out(), this->_repos ) == 0 && git_config_iterator_new( it.out(), config ) == 0 )
+            {
+                while( git_config_next( &entry, it ) == 0 )
+                {
+                    std::string key( entry->name );
+                    
+                    for( const std::string & suffix: { std::string( ".url" ), std::string( ".pushurl" ) } )
+                    {
+                        if( key.length() > 7 + suffix.length() && key.compare( 0, 7, "remote." ) == 0 && key.compare( key.length() - suffix.length(), suffix.length(), suffix ) == 0 )
+                        {
+                            names.insert( key.substr( 7, key.length() - 7 - suffix.length() ) );
+                        }
+                    }
+                }
+            }
+            
+            for( const auto & name: names )
+            {
+                RemoteHandle remote;
+                
+                if( git_remote_lookup( remote.out(), this->_repos, name.c_str() ) == 0 && remote != nullptr )
+                {
+                    this->_remotes.push_back( std::move( remote ) );
+                }
+            }
         }
     }
+    
+    std::map< std::string, git_oid > Repository::IMPL::tips( std::string & head ) const
+    {
+        std::map< std::string, git_oid > tips;
+        
+        head.clear();
+        
+        for( size_t i = 0; i < this->_refs->count(); i++ )
+        {
+            std::string name( this->_refs->shortName( i ) );
+            
+            tips[ name ] = this->_refs->oid( i );
+            
+            if( this->_refs->isRemote( i ) == false && this->_refs->name( i ) == this->_refs->head() )
+            {
+                head = name;
+            }
+        }
+        
+        return tips;
+    }
+    
+    Repository::IMPL::Upstreams & Repository::IMPL::upstreams( void )
+    {
+        static Upstreams * upstreams( new Upstreams() );
+        
+        return *( upstreams );
+    }
+    
+    Utility::ThreadPool & Repository::IMPL::submodulePool( void )
+    {
+        static Utility::ThreadPool * pool( new Utility::ThreadPool( std::min< size_t >( std::max( std::thread::hardware_concurrency(), 1U ), 8 ) ) );
+        
+        return *( pool );
+    }
+    
+    std::vector< std::pair< std::string, std::string > > Repository::IMPL::submoduleNames( git_repository * repos )
+    {
+        std::vector< std::pair< std::string, std::string > > names;
+        const char                                         * workdir( git_repository_workdir( repos ) );
+        
+        if( workdir == nullptr )
+        {
+            return names;
+        }
+        
+        git_submodule_foreach
+        (
+            repos,
+            []( git_submodule * submodule, const char * name, void * payload ) -> int
+            {
+                static_cast< std::vector< std::pair< std::string, std::string > > * >( payload )->push_back( { name, git_submodule_path( submodule ) } );
+                
+                return 0;
+            },
+            &names
+        );
+        
+        for( auto & name: names )
+        {
+            name.second = std::string( workdir ) + name.second;
+        }
+        
+        return names;
+    }
+    
+    void Repository::IMPL::watch( git_repository * repos, Utility::Watcher & watcher, size_t depth )
+    {
+        std::string                gitDirectory( git_repository_path( repos ) );
+        std::string                commonDirectory( git_repository_commondir( repos ) );
+        std::vector< std::string > gitFiles( { "HEAD" } );
+        std::vector< std::string > commonFiles( { "packed-refs", "config" } );
+        
+        for( std::string * directory: { &gitDirectory, &commonDirectory } )
+        {
+            while( directory->size() > 1 && directory->back() == '/' )
+            {
+                directory->pop_back();
+            }
+        }
+        
+        /*
+         * FETCH_HEAD tells about fetches made by others. When fetching
+         * itself, FETCH_HEAD is rewritten by each fetch, and watching it
+         * would trigger the next fetch right away.
+         */
+        if( Utility::Arguments::sharedInstance().fetchOrigin() == false )
+        {
+            gitFiles.push_back( "FETCH_HEAD" );
+            commonFiles.push_back( "FETCH_HEAD" );
+        }
+        
+        /* Refs are only read from these, and the config holds the upstreams */
+        watcher.watchFiles( gitDirectory,    gitFiles );
+        watcher.watchFiles( commonDirectory, commonFiles );
+        watcher.watchTree( commonDirectory + "/refs" );
+        
+        for( const auto & directory: { commonDirectory, gitDirectory } )
+        {
+            if( Reftable::exists( directory + "/reftable" ) )
+            {
+                watcher.watchFiles( directory + "/reftable", { "tables.list" } );
+            }
+        }
+        
+        /* Linked worktrees have their own HEAD */
+        {
+            StrArray names;
+            
+            if( git_worktree_list( names.get(), repos ) == 0 )
+            {
+                for( size_t i = 0; i < names->count; i++ )
+                {
+                    std::string directory( commonDirectory + "/worktrees/" + names->strings[ i ] );
+                    
+                    watcher.watchFiles( directory, { "HEAD" } );
+                    
+                    if( Reftable::exists( directory + "/reftable" ) )
+                    {
+                        watcher.watchFiles( directory + "/reftable", { "tables.list" } );
+                    }
+                }
+            }
+        }
+        
+        /* Submodules have their own refs, in their own Git directory */
+        if( depth < 16 && Utility::Arguments::sharedInstance().submodules() )
+        {
+            for( const auto & found: IMPL::submoduleNames( repos ) )
+            {
+                RepositoryHandle submodule;
+                
+                if( git_repository_open( submodule.out(), found.second.c_str() ) == 0 && submodule != nullptr )
+                {
+                    IMPL::watch( submodule, watcher, depth + 1 );
+                }
+            }
+        }
+    }
+    
+    git_repository * Repository::IMPL::handle( size_t worker )
+    {
+        if( this->_handles[ worker ] == nullptr )
+        {
+            if( git_repository_open( this->_handles[ worker ].out(), this->_path.c_str() ) != 0 || this->_handles[ worker ] == nullptr )
+            {
+                throw std::runtime_error( "Cannot open Git repository: " + this->_path );
+            }
+            
+            /* Workers share the object database, and so its object cache and mapped packs */
+            {
+                ODBHandle odb;
+                
+                if( git_repository_odb( odb.out(), this->_repos ) == 0 && odb != nullptr )
+                {
+                    git_repository_set_odb( this->_handles[ worker ], odb );
+                }
+            }
+        }
+        
+        return this->_handles[ worker ];
+    }
+    
+    Utility::Optional< CommitInfo > Repository::IMPL::commit( const git_oid & oid )
+    {
+        Utility::Optional< CommitInfo > info( this->_cache->commit( oid ) );
+        
+        if( info.hasValue() )
+        {
+            return info;
+        }
+        
+        info = CommitInfo::read( this->_repos, oid );
+        
+        if( info.hasValue() )
+        {
+            this->_cache->setCommit( *( info ) );
+        }
+        
+        return info;
+    }
+    
+    Utility::Optional< BranchStatus > Repository::IMPL::headStatus( void )
+    {
+        std::string                                      ref;
+        git_oid                                          oid;
+        std::string                                      name( "(detached)" );
+        std::string                                      upstream;
+        Utility::Optional< std::pair< size_t, size_t > > upstreamCounts;
+        
+        if( this->_refs->readHead( git_repository_path( this->_repos ), ref, oid ) == false )
+        {
+            return {};
+        }
+        
+        if( ref.length() > 0 )
+        {
+            size_t index( 0 );
+            bool   found( this->_refs->find( ref, index ) );
+            
+            name = ( ref.compare( 0, 11, "refs/heads/" ) == 0 ) ? ref.substr( 11 ) : ref;
+            
+            if( found )
+            {
+                git_oid_cpy( &oid, &( this->_refs->oid( index ) ) );
+            }
+            else if( git_reference_name_to_id( &oid, this->_repos, ref.c_str() ) != 0 )
+            {
+                return {};
+            }
+            
+            /* Only the upstream of the checked out branch matters here */
+            if( this->_upstreamed == false )
+            {
+                this->upstream( ref );
+            }
+            
+            if( this->_upstreams.count( name ) > 0 )
+            {
+                upstream       = this->_upstreams[ name ];
+                upstreamCounts = Utility::Optional< std::pair< size_t, size_t > >( this->_upstreamCounts[ name ] );
+            }
+        }
+        
+        return BranchStatus( name, true, this->commit( oid ), {}, false, upstream, upstreamCounts );
+    }
+    
+    void Repository::IMPL::graph( const Repository & repos )
+    {
+        std::vector< Branch >        branches( repos.branches() );
+        Utility::Optional< git_oid > head;
+        std::vector< std::string >   names;
+        std::vector< git_oid >       tips;
+        
+        this->_graphed = true;
+        
+        for( const auto & branch: branches )
+        {
+            Utility::Optional< git_oid > oid( branch.target() );
+            
+            if( oid.hasValue() == false )
+            {
+                continue;
+            }
+            
+            if( branch.isHead() )
+            {
+                head = oid;
+            }
+            else if( this->_aheadBehind.count( branch.name() ) == 0 )
+            {
+                names.push_back( branch.name() );
+                tips.push_back( *( oid ) );
+            }
+        }
+        
+        if( head.hasValue() == false || tips.size() == 0 )
+        {
+            return;
+        }
+        
+        {
+            Utility::ThreadPool                          & pool( Utility::ThreadPool::shared() );
+            std::vector< std::pair< size_t, size_t > >     counts( names.size(), { 0, 0 } );
+            std::vector< uint8_t >                         resolved( names.size(), 0 );
+            std::vector< uint8_t >                         saturated( names.size(), 0 );
+            Utility::Arguments                           & args( Utility::Arguments::sharedInstance() );
+            std::vector< size_t >                          missing;
+            std::vector< std::function< void( size_t ) > > tasks;
+            
+            for( size_t i = 0; i < names.size(); i++ )
+            {
+                tasks.push_back
+                (
+                    [ &, i ]( size_t worker )
+                    {
+                        Utility::Optional< std::pair< size_t, size_t > > cached( this->_cache->aheadBehind( *( head ), tips[ i ] ) );
+                        git_oid                                          previousBase;
+                        git_oid                                          previousTip;
+                        std::pair< size_t, size_t >                      previousCounts;
+                        
+                        if( cached.hasValue() == false && this->_history != nullptr && this->_history->get( names[ i ], previousBase, previousTip, previousCounts ) )
+                        {
+                            try
+                            {
+                                cached = Graph( this->handle( worker ) ).fastForward( *( head ), tips[ i ], previousBase, previousTip, previousCounts );
+                            }
+                            catch( ... )
+                            {
+                                /* Unreadable tips are left to the walks below, which skip them */
+                                return;
+                            }
+                            
+                            if( cached.hasValue() )
+                            {
+                                this->_cache->setAheadBehind( *( head ), tips[ i ], *( cached ) );
+                            }
+                        }
+                        
+                        if( cached.hasValue() )
+                        {
+                            counts[ i ]   = *( cached );
+                            resolved[ i ] = 1;
+                        }
+                    }
+                );
+            }
+            
+            pool.run( tasks );
+            tasks.clear();
+            
+            for( size_t i = 0; i < names.size(); i++ )
+            {
+                if( resolved[ i ] == 0 )
+                {
+                    missing.push_back( i );
+                }
+            }
+            
+            /*
+             * Missing tips are split in chunks, each counted by one batch walk
+             * on its own worker. Chunks aren't too small, as each walk has to
+             * cover the history shared by its tips.
+             * Walks may be capped by the arguments, in which case the counts
+             * of unfinished tips are lower bounds, and are never cached.
+             */
+            {
+                size_t chunks( std::min( pool.count(), ( missing.size() + minChunkSize - 1 ) / minChunkSize ) );
+                
+                for( size_t c = 0; c < chunks; c++ )
+                {
+                    tasks.push_back
+                    (
+                        [ &, c, chunks ]( size_t worker )
+                        {
+                            std::vector< size_t >  indices;
+                            std::vector< git_oid > chunk;
+                            
+                            for( size_t i = c; i < missing.size(); i += chunks )
+                            {
+                                indices.push_back( missing[ i ] );
+                                chunk.push_back( tips[ missing[ i ] ] );
+                            }
+                            
+                            {
+                                std::vector< bool >                        stopped;
+                                std::vector< std::pair< size_t, size_t > > computed;
+                                std::vector< uint8_t >                     readable( chunk.size(), 1 );
+                                
+                                try
+                                {
+                                    computed = Graph( this->handle( worker ), args.maxWalk(), args.maxTime() ).aheadBehind( *( head ), chunk, stopped );
+                                }
+                                catch( ... )
+                                {
+                                    /* One unreadable tip fails the whole walk, so the chunk is counted again tip by tip */
+                                    computed.assign( chunk.size(), { 0, 0 } );
+                                    stopped.assign( chunk.size(), false );
+                                    
+                                    for( size_t i = 0; i < chunk.size(); i++ )
+                                    {
+                                        try
+                                        {
+                                            std::vector< bool > tipStopped;
+                                            
+                                            computed[ i ] = Graph( this->handle( worker ), args.maxWalk(), args.maxTime() ).aheadBehind( *( head ), { chunk[ i ] }, tipStopped ).front();
+                                            stopped[ i ]  = tipStopped.front();
+                                        }
+                                        catch( ... )
+                                        {
+                                            readable[ i ] = 0;
+                                        }
+                                    }
+                                }
+                                
+                                for( size_t i = 0; i < indices.size(); i++ )
+                                {
+                                    if( readable[ i ] == 0 )
+                                    {
+                                        continue;
+                                    }
+                                    
+                                    counts[ indices[ i ] ]    = computed[ i ];
+                                    resolved[ indices[ i ] ]  = 1;
+                                    saturated[ indices[ i ] ] = ( stopped[ i ] ) ? 1 : 0;
+                                    
+                                    if( stopped[ i ] == false )
+                                    {
+                                        this->_cache->setAheadBehind( *( head ), chunk[ i ], computed[ i ] );
+                                    }
+                                }
+                            }
+                        }
+                    );
+                }
+                
+                pool.run( tasks );
+            }
+            
+            for( size_t i = 0; i < names.size(); i++ )
+            {
+                if( resolved[ i ] != 0 )
+                {
+                    this->_aheadBehind[ names[ i ] ] = counts[ i ];
+                }
+                
+                if( saturated[ i ] != 0 )
+                {
+                    this->_saturated.insert( names[ i ] );
+                }
+            }
+            
+            if( this->_history != nullptr )
+            {
+                for( size_t i = 0; i < names.size(); i++ )
+                {
+                    if( this->_aheadBehind.count( names[ i ] ) > 0 && this->_saturated.count( names[ i ] ) == 0 )
+                    {
+                        this->_history->set( names[ i ], *( head ), tips[ i ], this->_aheadBehind[ names[ i ] ] );
+                    }
+                }
+            }
+        }
+    }
+    
+    void Repository::IMPL::upstream( const std::string & ref )
+    {
+        std::vector< std::string >                             names;
+        std::vector< std::pair< git_oid, git_oid > >           pairs;
+        std::vector< std::pair< size_t, size_t > >             counts;
+        std::vector< size_t >                                  missing;
+        std::map< std::string, std::pair< git_oid, git_oid > > previousPairs;
+        std::map< std::string, std::pair< size_t, size_t > >   previousCounts;
+        
+        /* An empty ref resolves all local branches, otherwise only that one is counted */
+        if( ref.length() == 0 )
+        {
+            this->_upstreamed = true;
+            
+            std::swap( previousPairs, this->_upstreamPairs );
+            std::swap( previousCounts, this->_upstreamCounts );
+            this->_upstreams.clear();
+        }
+        
+        /*
+         * Upstream names come from the configuration, which only changes
+         * when the config file does. They are kept across snapshots, so
+         * each branch is resolved once, and only its target is looked up.
+         * Names are resolved from a single config snapshot, as
+         * git_branch_upstream() parses the whole configuration again for
+         * every branch.
+         */
+        {
+            Upstreams                   & upstreams( IMPL::upstreams() );
+            std::string                   directory( git_repository_commondir( this->_repos ) );
+            std::lock_guard< std::mutex > l( upstreams._mtx );
+            struct stat                   st;
+            ConfigHandle                  config;
+            
+            memset( &st, 0, sizeof( struct stat ) );
+            stat( ( directory + "/config" ).c_str(), &st );
+            
+            {
+                Upstreams::Entry & entry( upstreams._entries[ directory ] );
+                
+                if( entry._time != st.st_mtime || entry._size != st.st_size )
+                {
+                    entry._time = st.st_mtime;
+                    entry._size = st.st_size;
+                    
+                    entry._names.clear();
+                }
+                
+                std::map< std::string_view, size_t > index;
+                
+                for( size_t i = 0; i < this->_refs->count(); i++ )
+                {
+                    index[ this->_refs->name( i ) ] = i;
+                }
+                
+                for( size_t i = 0; i < this->_refs->count(); i++ )
+                {
+                    std::string refname( this->_refs->name( i ) );
+                    std::string name( this->_refs->shortName( i ) );
+                    git_oid     remote;
+                    
+                    if( this->_refs->isRemote( i ) || ( ref.length() > 0 && refname != ref ) )
+                    {
+                        continue;
+                    }
+                    
+                    if( ref.length() > 0 )
+                    {
+                        previousPairs.insert( this->_upstreamPairs.extract( name ) );
+                        previousCounts.insert( this->_upstreamCounts.extract( name ) );
+                        this->_upstreams.erase( name );
+                    }
+                    
+                    if( entry._names.count( refname ) == 0 )
+                    {
+                        if( config == nullptr && git_repository_config_snapshot( config.out(), this->_repos ) != 0 )
+                        {
+                            break;
+                        }
+                        
+                        entry._names[ refname ] = this->upstreamName( config, name );
+                    }
+                    
+                    {
+                        std::string upstream( entry._names[ refname ] );
+                        auto        it( index.find( upstream ) );
+                        
+                        if( upstream.length() == 0 )
+                        {
+                            continue;
+                        }
+                        
+                        if( it != index.end() )
+                        {
+                            git_oid_cpy( &remote, &( this->_refs->oid( it->second ) ) );
+                        }
+                        else if( git_reference_name_to_id( &remote, this->_repos, upstream.c_str() ) != 0 )
+                        {
+                            continue;
+                        }
+                        
+                        for( const std::string & prefix: { std::string( "refs/remotes/" ), std::string( "refs/heads/" ) } )
+                        {
+                            if( upstream.compare( 0, prefix.length(), prefix ) == 0 )
+                            {
+                                upstream = upstream.substr( prefix.length() );
+                                
+                                break;
+                            }
+                        }
+                        
+                        this->_upstreams[ name ] = upstream;
+                        
+                        names.push_back( name );
+                        pairs.push_back( { this->_refs->oid( i ), remote } );
+                    }
+                }
+            }
+        }
+        
+        counts.resize( pairs.size(), { 0, 0 } );
+        
+        /* Pairs which didn't move since the previous refresh keep their counts */
+        for( size_t i = 0; i < pairs.size(); i++ )
+        {
+            Utility::Optional< std::pair< size_t, size_t > > cached;
+            auto                                             it( previousPairs.find( names[ i ] ) );
+            
+            if( it != previousPairs.end() && git_oid_equal( &( it->second.first ), &( pairs[ i ].first ) ) && git_oid_equal( &( it->second.second ), &( pairs[ i ].second ) ) && previousCounts.count( names[ i ] ) > 0 )
+            {
+                cached = Utility::Optional< std::pair< size_t, size_t > >( previousCounts[ names[ i ] ] );
+            }
+            else
+            {
+                cached = this->_cache->aheadBehind( pairs[ i ].first, pairs[ i ].second );
+            }
+            
+            if( cached.hasValue() )
+            {
+                counts[ i ] = *( cached );
+            }
+            else
+            {
+                missing.push_back( i );
+            }
+        }
+        
+        /* Pairs are counted in chunks, two bits per pair, like HEAD comparisons */
+        {
+            Utility::ThreadPool                          & pool( Utility::ThreadPool::shared() );
+            std::vector< std::function< void( size_t ) > > tasks;
+            size_t                                         chunks( std::min( pool.count(), ( missing.size() + minChunkSize - 1 ) / minChunkSize ) );
+            
+            for( size_t c = 0; c < chunks; c++ )
+            {
+                tasks.push_back
+                (
+                    [ &, c, chunks ]( size_t worker )
+                    {
+                        std::vector< size_t >                        indices;
+                        std::vector< std::pair< git_oid, git_oid > > chunk;
+                        
+                        for( size_t i = c; i < missing.size(); i += chunks )
+                        {
+                            indices.push_back( missing[ i ] );
+                            chunk.push_back( pairs[ missing[ i ] ] );
+                        }
+                        
+                        {
+                            std::vector< std::pair< size_t, size_t > > computed( Graph( this->handle( worker ) ).aheadBehind( chunk ) );
+                            
+                            for( size_t i = 0; i < indices.size(); i++ )
+                            {
+                                counts[ indices[ i ] ] = computed[ i ];
+                                
+                                this->_cache->setAheadBehind( chunk[ i ].first, chunk[ i ].second, computed[ i ] );
+                            }
+                        }
+                    }
+                );
+            }
+            
+            pool.run( tasks );
+        }
+        
+        for( size_t i = 0; i < names.size(); i++ )
+        {
+            this->_upstreamCounts[ names[ i ] ] = counts[ i ];
+            this->_upstreamPairs[ names[ i ] ]  = pairs[ i ];
+        }
+    }
+    
+    std::string Repository::IMPL::upstreamName( git_config * config, const std::string & branch )
+    {
+        const char * remote( nullptr );
+        const char * merge( nullptr );
+        
+        if( git_config_get_string( &remote, config, ( "branch." + branch + ".remote" ).c_str() ) != 0 || remote == nullptr )
+        {
+            return "";
+        }
+        
+        if( git_config_get_string( &merge, config, ( "branch." + branch + ".merge" ).c_str() ) != 0 || merge == nullptr )
+        {
+            return "";
+        }
+        
+        if( std::string( remote ) == "." )
+        {
+            return merge;
+        }
+        
+        for( const auto & r: this->_remotes )
+        {
+            if( std::string( git_remote_name( r ) ) != remote )
+            {
+                continue;
+            }
+            
+            for( size_t i = 0; i < git_remote_refspec_count( r ); i++ )
+            {
+                const git_refspec * spec( git_remote_get_refspec( r, i ) );
+                Buffer              buf;
+                std::string         name;
+                
+                if( spec == nullptr || git_refspec_direction( spec ) != GIT_DIRECTION_FETCH || git_refspec_src_matches( spec, merge ) == 0 )
+                {
+                    continue;
+                }
+                
+                if( git_refspec_transform( buf.get(), spec, merge ) == 0 && buf->ptr != nullptr )
+                {
+                    name = buf->ptr;
+                }
+                
+                return name;
+            }
+        }
+        
+        return "";
+    }
 }
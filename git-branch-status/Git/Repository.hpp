@@ -37,7 +37,15 @@
 #include <git2.h>
 #include "Branch.hpp"
 #include "Remote.hpp"
+#include "DiskCache.hpp"
+#include "History.hpp"
+#include "BranchStatus.hpp"
+#include "BranchSnapshot.hpp"
+#include "RefDelta.hpp"
+#include "Worktree.hpp"
+#include "Submodule.hpp"
 #include "Optional.hpp"
+#include "Watcher.hpp"
 
 namespace Git
 {
@@ -46,6 +54,7 @@ namespace Git
         public:
             
             Repository( const std::string & path );
+            Repository( const std::string & path, History & history );
             Repository( const Repository & o );
             ~Repository( void );
             
@@ -56,10 +65,23 @@ namespace Git
             bool operator ==( const Repository & o ) const;
             bool operator !=( const Repository & o ) const;
             
-            std::string                 path( void )     const;
-            std::vector< Branch >       branches( void ) const;
-            std::vector< Remote >       remotes( void )  const;
-            Utility::Optional< Branch > head( void )     const;
+            std::string                       path( void )       const;
+            std::vector< Branch >             branches( void )   const;
+            std::vector< Remote >             remotes( void )    const;
+            Utility::Optional< Branch >       head( void )       const;
+            DiskCache                       & cache( void )      const;
+            std::vector< BranchStatus >       status( void )     const;
+            BranchSnapshot                    snapshot( void )   const;
+            Utility::Optional< BranchStatus > headStatus( void ) const;
+            
+            std::vector< Worktree >  worktrees( const BranchSnapshot & snapshot ) const;
+            std::vector< Submodule > submodules( void )                           const;
+            
+            RefDelta refresh( void );
+            void     watch( Utility::Watcher & watcher ) const;
+            
+            bool                                                      aheadBehind( const Branch & branch, size_t & ahead, size_t & behind ) const;
+            std::vector< std::vector< std::pair< size_t, size_t > > > matrix( const std::vector< Branch > & branches )                  const;
             
             friend void swap( Repository & o1, Repository & o2 );
             
@@ -0,0 +1,136 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @file        RepositoryStatus.cpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "RepositoryStatus.hpp"
+
+namespace Git
+{
+    class RepositoryStatus::IMPL
+    {
+        public:
+            
+            IMPL( const std::string & path, const Utility::Optional< BranchStatus > & head, const std::string & error, time_t changed );
+            IMPL( const IMPL & o );
+            ~IMPL( void );
+            
+            std::string                       _path;
+            Utility::Optional< BranchStatus > _head;
+            std::string                       _error;
+            time_t                            _changed;
+    };
+    
+    RepositoryStatus::RepositoryStatus( const std::string & path, const Utility::Optional< BranchStatus > & head, const std::string & error, time_t changed ): impl( std::make_shared< IMPL >( path, head, error, changed ) )
+    {}
+    
+    RepositoryStatus::RepositoryStatus( const RepositoryStatus & o ): impl( std::make_shared< IMPL >( *( o.impl ) ) )
+    {}
+    
+    RepositoryStatus::~RepositoryStatus( void )
+    {}
+    
+    RepositoryStatus & RepositoryStatus::operator =( RepositoryStatus o )
+    {
+        swap( *( this ), o );
+        
+        return *( this );
+    }
+    
+    std::string RepositoryStatus::path( void ) const
+    {
+        return this->impl->_path;
+    }
+    
+    const Utility::Optional< BranchStatus > & RepositoryStatus::head( void ) const
+    {
+        return this->impl->_head;
+    }
+    
+    std::string RepositoryStatus::error( void ) const
+    {
+        return this->impl->_error;
+    }
+    
+    time_t RepositoryStatus::changed( void ) const
+    {
+        return this->impl->_changed;
+    }
+    
+    size_t RepositoryStatus::attention( void ) const
+    {
+        size_t ahead( 0 );
+        size_t behind( 0 );
+        
+        /* Errors first, then branches which diverged from their upstream, are behind, or have unpushed commits */
+        if( this->impl->_error.length() > 0 )
+        {
+            return 4;
+        }
+        
+        if( this->impl->_head.hasValue() == false || this->impl->_head->upstreamAheadBehind( ahead, behind ) == false )
+        {
+            return 0;
+        }
+        
+        if( ahead > 0 && behind > 0 )
+        {
+            return 3;
+        }
+        
+        if( behind > 0 )
+        {
+            return 2;
+        }
+        
+        return ( ahead > 0 ) ? 1 : 0;
+    }
+    
+    void swap( RepositoryStatus & o1, RepositoryStatus & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    RepositoryStatus::IMPL::IMPL( const std::string & path, const Utility::Optional< BranchStatus > & head, const std::string & error, time_t changed ):
+        _path( path ),
+        _head( head ),
+        _error( error ),
+        _changed( changed )
+    {}
+    
+    RepositoryStatus::IMPL::IMPL( const IMPL & o ):
+        _path( o._path ),
+        _head( o._head ),
+        _error( o._error ),
+        _changed( o._changed )
+    {}
+    
+    RepositoryStatus::IMPL::~IMPL( void )
+    {}
+}
@@ -0,0 +1,68 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @header      RepositoryStatus.hpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef GIT_REPOSITORY_STATUS_HPP
+#define GIT_REPOSITORY_STATUS_HPP
+
+#include <string>
+#include <memory>
+#include <algorithm>
+#include <ctime>
+#include "BranchStatus.hpp"
+#include "Optional.hpp"
+
+namespace Git
+{
+    class RepositoryStatus
+    {
+        public:
+            
+            RepositoryStatus( const std::string & path, const Utility::Optional< BranchStatus > & head, const std::string & error, time_t changed );
+            RepositoryStatus( const RepositoryStatus & o );
+            ~RepositoryStatus( void );
+            
+            RepositoryStatus & operator =( RepositoryStatus o );
+            
+            std::string                               path( void )      const;
+            const Utility::Optional< BranchStatus > & head( void )      const;
+            std::string                               error( void )     const;
+            time_t                                    changed( void )   const;
+            size_t                                    attention( void ) const;
+            
+            friend void swap( RepositoryStatus & o1, RepositoryStatus & o2 );
+            
+        private:
+            
+            class IMPL;
+            
+            std::shared_ptr< IMPL > impl;
+    };
+}
+
+#endif /* GIT_REPOSITORY_STATUS_HPP */
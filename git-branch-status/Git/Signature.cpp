@@ -78,12 +78,12 @@ namespace Git
         return !operator ==( o );
     }
     
-    std::string Signature::name( void ) const
+    std::string_view Signature::name( void ) const
     {
         return ( this->impl->_signature->name == nullptr ) ? "" : this->impl->_signature->name;
     }
     
-    std::string Signature::email( void ) const
+    std::string_view Signature::email( void ) const
     {
         return ( this->impl->_signature->email == nullptr ) ? "" : this->impl->_signature->email;
     }
@@ -31,6 +31,7 @@
 #define GIT_SIGNATURE_HPP
 
 #include <string>
+#include <string_view>
 #include <memory>
 #include <vector>
 #include <algorithm>
@@ -55,8 +56,8 @@ namespace Git
             bool operator ==( const Signature & o ) const;
             bool operator !=( const Signature & o ) const;
             
-            std::string name( void )  const;
-            std::string email( void ) const;
+            std::string_view name( void )  const;
+            std::string_view email( void ) const;
             
             friend void swap( Signature & o1, Signature & o2 );
             
@@ -0,0 +1,107 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @file        Submodule.cpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "Submodule.hpp"
+
+namespace Git
+{
+    class Submodule::IMPL
+    {
+        public:
+            
+            IMPL( const std::string & name, const std::string & path, size_t depth, const Utility::Optional< BranchStatus > & status );
+            IMPL( const IMPL & o );
+            ~IMPL( void );
+            
+            std::string                       _name;
+            std::string                       _path;
+            size_t                            _depth;
+            Utility::Optional< BranchStatus > _status;
+    };
+    
+    Submodule::Submodule( const std::string & name, const std::string & path, size_t depth, const Utility::Optional< BranchStatus > & status ): impl( std::make_shared< IMPL >( name, path, depth, status ) )
+    {}
+    
+    Submodule::Submodule( const Submodule & o ): impl( std::make_shared< IMPL >( *( o.impl ) ) )
+    {}
+    
+    Submodule::~Submodule( void )
+    {}
+    
+    Submodule & Submodule::operator =( Submodule o )
+    {
+        swap( *( this ), o );
+        
+        return *( this );
+    }
+    
+    std::string Submodule::name( void ) const
+    {
+        return this->impl->_name;
+    }
+    
+    std::string Submodule::path( void ) const
+    {
+        return this->impl->_path;
+    }
+    
+    size_t Submodule::depth( void ) const
+    {
+        return this->impl->_depth;
+    }
+    
+    const Utility::Optional< BranchStatus > & Submodule::status( void ) const
+    {
+        return this->impl->_status;
+    }
+    
+    void swap( Submodule & o1, Submodule & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    Submodule::IMPL::IMPL( const std::string & name, const std::string & path, size_t depth, const Utility::Optional< BranchStatus > & status ):
+        _name( name ),
+        _path( path ),
+        _depth( depth ),
+        _status( status )
+    {}
+    
+    Submodule::IMPL::IMPL( const IMPL & o ):
+        _name( o._name ),
+        _path( o._path ),
+        _depth( o._depth ),
+        _status( o._status )
+    {}
+    
+    Submodule::IMPL::~IMPL( void )
+    {}
+}
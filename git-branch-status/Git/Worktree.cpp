@@ -0,0 +1,120 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @file        Worktree.cpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "Worktree.hpp"
+
+namespace Git
+{
+    class Worktree::IMPL
+    {
+        public:
+            
+            IMPL( const std::string & name, const std::string & path, bool current, bool detached, const BranchStatus & status );
+            IMPL( const IMPL & o );
+            ~IMPL( void );
+            
+            std::string  _name;
+            std::string  _path;
+            bool         _current;
+            bool         _detached;
+            BranchStatus _status;
+    };
+    
+    Worktree::Worktree( const std::string & name, const std::string & path, bool current, bool detached, const BranchStatus & status ): impl( std::make_shared< IMPL >( name, path, current, detached, status ) )
+    {}
+    
+    Worktree::Worktree( const Worktree & o ): impl( std::make_shared< IMPL >( *( o.impl ) ) )
+    {}
+    
+    Worktree::~Worktree( void )
+    {}
+    
+    Worktree & Worktree::operator =( Worktree o )
+    {
+        swap( *( this ), o );
+        
+        return *( this );
+    }
+    
+    std::string Worktree::name( void ) const
+    {
+        return this->impl->_name;
+    }
+    
+    std::string Worktree::path( void ) const
+    {
+        return this->impl->_path;
+    }
+    
+    bool Worktree::isMain( void ) const
+    {
+        return this->impl->_name.length() == 0;
+    }
+    
+    bool Worktree::isCurrent( void ) const
+    {
+        return this->impl->_current;
+    }
+    
+    bool Worktree::isDetached( void ) const
+    {
+        return this->impl->_detached;
+    }
+    
+    const BranchStatus & Worktree::status( void ) const
+    {
+        return this->impl->_status;
+    }
+    
+    void swap( Worktree & o1, Worktree & o2 )
+    {
+        using std::swap;
+        
+        swap( o1.impl, o2.impl );
+    }
+    
+    Worktree::IMPL::IMPL( const std::string & name, const std::string & path, bool current, bool detached, const BranchStatus & status ):
+        _name( name ),
+        _path( path ),
+        _current( current ),
+        _detached( detached ),
+        _status( status )
+    {}
+    
+    Worktree::IMPL::IMPL( const IMPL & o ):
+        _name( o._name ),
+        _path( o._path ),
+        _current( o._current ),
+        _detached( o._detached ),
+        _status( o._status )
+    {}
+    
+    Worktree::IMPL::~IMPL( void )
+    {}
+}
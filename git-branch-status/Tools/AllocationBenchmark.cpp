@@ -0,0 +1,151 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @file        AllocationBenchmark.cpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <functional>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include "Arguments.hpp"
+#include "Repository.hpp"
+#include "BranchRow.hpp"
+
+/*
+ * Counts the allocations made by Repository::status(), once when the
+ * repository was just opened, then once warm, with and without a refresh
+ * before each call, and those made by formatting a frame, i.e. the rows of
+ * every branch, as drawn on a screen of frameWidth columns. Only C++
+ * allocations are counted, through a replaced global operator new; libgit2
+ * allocates with malloc() directly.
+ */
+
+static constexpr size_t iterations = 1000;
+static constexpr size_t frameWidth = 160;
+
+static std::atomic< size_t > allocations( 0 );
+static std::atomic< size_t > allocatedBytes( 0 );
+
+static void measure( const std::string & name, size_t count, const std::function< void( void ) > & f );
+
+void * operator new( size_t size )
+{
+    void * p( malloc( ( size > 0 ) ? size : 1 ) );
+    
+    if( p == nullptr )
+    {
+        throw std::bad_alloc();
+    }
+    
+    allocations++;
+    allocatedBytes += size;
+    
+    return p;
+}
+
+void operator delete( void * p ) noexcept
+{
+    free( p );
+}
+
+void operator delete( void * p, size_t ) noexcept
+{
+    free( p );
+}
+
+int main( int argc, char * argv[] )
+{
+    Utility::Arguments args( argc, argv );
+    
+    try
+    {
+        Git::History    history;
+        Git::Repository repos( ( args.path().length() > 0 ) ? args.path() : ".", history );
+        
+        measure( "status (cold)",    1,          [ & ] { repos.status(); } );
+        measure( "status",           iterations, [ & ] { repos.status(); } );
+        measure( "refresh + status", iterations, [ & ] { repos.refresh(); repos.status(); } );
+        measure( "headStatus",       iterations, [ & ] { repos.headStatus(); } );
+        
+        {
+            Git::BranchSnapshot snapshot( repos.snapshot() );
+            UI::BranchRow       row;
+            auto                frame
+            (
+                [ & ]
+                {
+                    size_t upstreamWidth( ( args.upstream() ) ? UI::BranchRow::upstreamWidth( snapshot ) : 0 );
+                    
+                    for( const auto & branch: snapshot.branches() )
+                    {
+                        row.format( branch, snapshot, args.upstream(), upstreamWidth, frameWidth );
+                    }
+                }
+            );
+            
+            measure( "frame (cold)", 1,          frame );
+            measure( "frame",        iterations, frame );
+        }
+    }
+    catch( const std::exception & e )
+    {
+        std::cerr << e.what() << std::endl;
+        
+        return EXIT_FAILURE;
+    }
+    
+    return EXIT_SUCCESS;
+}
+
+static void measure( const std::string & name, size_t count, const std::function< void( void ) > & f )
+{
+    size_t                                previousAllocations( allocations );
+    size_t                                previousBytes( allocatedBytes );
+    std::chrono::steady_clock::time_point start( std::chrono::steady_clock::now() );
+    
+    for( size_t i = 0; i < count; i++ )
+    {
+        f();
+    }
+    
+    {
+        std::chrono::steady_clock::duration elapsed( std::chrono::steady_clock::now() - start );
+        
+        std::cout << name
+                  << ": "
+                  << ( allocations - previousAllocations ) / count
+                  << " allocations, "
+                  << ( allocatedBytes - previousBytes ) / count
+                  << " bytes, "
+                  << std::chrono::duration_cast< std::chrono::microseconds >( elapsed ).count() / static_cast< long long >( count )
+                  << " us per call"
+                  << std::endl;
+    }
+}
@@ -0,0 +1,131 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @file        Soak.cpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <stdexcept>
+#include <unistd.h>
+#ifdef __APPLE__
+#include <mach/mach.h>
+#endif
+#include "Arguments.hpp"
+#include "Repository.hpp"
+
+/*
+ * Refreshes a repository in a loop, the way the main tool does on every
+ * change, and checks that the resident size doesn't grow once the caches
+ * are warm. The repository is only read, so it can be changed meanwhile
+ * (committing, fetching, switching branches) to exercise more paths.
+ */
+
+static constexpr size_t warmupIterations = 100;
+static constexpr size_t iterations       = 5000;
+static constexpr size_t sampleInterval   = 500;
+static constexpr size_t maxGrowth        = 4 * 1024 * 1024;
+
+static size_t residentSize( void );
+
+int main( int argc, char * argv[] )
+{
+    Utility::Arguments args( argc, argv );
+    
+    try
+    {
+        Git::History    history;
+        Git::Repository repos( ( args.path().length() > 0 ) ? args.path() : ".", history );
+        size_t          baseline( 0 );
+        size_t          rss( 0 );
+        
+        for( size_t i = 0; i < warmupIterations + iterations; i++ )
+        {
+            repos.refresh();
+            repos.status();
+            repos.headStatus();
+            
+            if( i + 1 == warmupIterations )
+            {
+                baseline = residentSize();
+                
+                std::cout << "Baseline: " << baseline / 1024 << " KB" << std::endl;
+            }
+            else if( i >= warmupIterations && ( i + 1 - warmupIterations ) % sampleInterval == 0 )
+            {
+                rss = residentSize();
+                
+                std::cout << "Iteration " << i + 1 - warmupIterations << ": " << rss / 1024 << " KB" << std::endl;
+            }
+        }
+        
+        if( rss > baseline + maxGrowth )
+        {
+            std::cerr << "Resident size grew by " << ( rss - baseline ) / 1024 << " KB" << std::endl;
+            
+            return EXIT_FAILURE;
+        }
+    }
+    catch( const std::exception & e )
+    {
+        std::cerr << e.what() << std::endl;
+        
+        return EXIT_FAILURE;
+    }
+    
+    return EXIT_SUCCESS;
+}
+
+static size_t residentSize( void )
+{
+    #ifdef __APPLE__
+    
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t      count( MACH_TASK_BASIC_INFO_COUNT );
+    
+    if( task_info( mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast< task_info_t >( &info ), &count ) != KERN_SUCCESS )
+    {
+        return 0;
+    }
+    
+    return info.resident_size;
+    
+    #else
+    
+    std::ifstream stream( "/proc/self/statm" );
+    size_t        size( 0 );
+    size_t        resident( 0 );
+    
+    if( !( stream >> size >> resident ) )
+    {
+        return 0;
+    }
+    
+    return resident * static_cast< size_t >( sysconf( _SC_PAGESIZE ) );
+    
+    #endif
+}
@@ -0,0 +1,372 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @file        BranchRow.cpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "BranchRow.hpp"
+#include "OID.hpp"
+#include <algorithm>
+#include <vector>
+#include <cstring>
+#include <ctime>
+
+namespace UI
+{
+    class BranchRow::IMPL
+    {
+        public:
+            
+            class Segment
+            {
+                public:
+                    
+                    std::size_t _x;
+                    std::string _text;
+                    int         _color;
+            };
+            
+            static void appendUpstream( const Git::BranchStatus & branch, std::string & info );
+            
+            IMPL( void );
+            
+            Segment & next( int color );
+            bool      place( Segment & segment );
+            
+            std::vector< Segment > _segments;
+            std::size_t            _count;
+            std::size_t            _column;
+            std::size_t            _width;
+            bool                   _full;
+    };
+    
+    std::string BranchRow::upstreamInfo( const Git::BranchStatus & branch )
+    {
+        std::string info;
+        
+        info.reserve( branch.upstream().length() + 40 );
+        IMPL::appendUpstream( branch, info );
+        
+        return info;
+    }
+    
+    std::size_t BranchRow::upstreamWidth( const Git::BranchSnapshot & snapshot )
+    {
+        std::string info;
+        std::size_t width( 0 );
+        
+        for( const auto & branch: snapshot.branches() )
+        {
+            info.clear();
+            IMPL::appendUpstream( branch, info );
+            
+            width = std::max( width, info.length() );
+        }
+        
+        return width;
+    }
+    
+    BranchRow::BranchRow( void ): impl( std::make_shared< IMPL >() )
+    {}
+    
+    BranchRow::~BranchRow( void )
+    {}
+    
+    void BranchRow::format( const Git::BranchStatus & branch, const Git::BranchSnapshot & snapshot, bool upstream, std::size_t upstreamWidth, std::size_t width )
+    {
+        std::string                          symbol;
+        int                                  color( 0 );
+        std::size_t                          ahead( 0 );
+        std::size_t                          behind( 0 );
+        Utility::Optional< Git::CommitInfo > headCommit;
+        bool                                 saturated( snapshot.hasSaturated() );
+        
+        this->impl->_count  = 0;
+        this->impl->_column = snapshot.longestName() + ( ( saturated ) ? 5 : 4 );
+        this->impl->_width  = width;
+        this->impl->_full   = false;
+        
+        if( width < 10 )
+        {
+            return;
+        }
+        
+        {
+            Utility::Optional< Git::BranchStatus > head( snapshot.head() );
+            
+            if( head.hasValue() )
+            {
+                headCommit = head->lastCommit();
+            }
+        }
+        
+        if( upstream )
+        {
+            branch.upstreamAheadBehind( ahead, behind );
+        }
+        else
+        {
+            branch.aheadBehind( ahead, behind );
+        }
+        
+        /* The whole row of the checked out branch is green, unless a segment has its own color */
+        if( branch.isHead() )
+        {
+            symbol = "@";
+            color  = 1;
+        }
+        else if( ahead > 0 && behind > 0 )
+        {
+            symbol = "%";
+            color  = 5;
+        }
+        else if( ahead > 0 )
+        {
+            symbol = ">";
+            color  = 3;
+        }
+        else if( behind > 0 )
+        {
+            symbol = "<";
+            color  = 4;
+        }
+        else if( upstream && branch.upstream().length() > 0 )
+        {
+            symbol = "=";
+            color  = 2;
+        }
+        else if( upstream )
+        {
+            symbol = "-";
+        }
+        else if( branch.lastCommit().hasValue() && headCommit.hasValue() && Git::OIDEqual()( branch.lastCommit()->oid(), headCommit->oid() ) )
+        {
+            symbol = "=";
+            color  = 2;
+        }
+        else
+        {
+            symbol = "?";
+            color  = 5;
+        }
+        
+        /* Saturated counts are lower bounds, as the walk was capped */
+        if( branch.isSaturated() )
+        {
+            symbol += "+";
+        }
+        else if( saturated )
+        {
+            symbol += " ";
+        }
+        
+        {
+            IMPL::Segment & segment( this->impl->next( color ) );
+            
+            if( branch.isHead() == false )
+            {
+                segment._text.append( "  " );
+            }
+            
+            segment._text.append( symbol ).append( " " ).append( branch.name(), 0, width - std::min( width, symbol.length() + 1 ) );
+            
+            this->impl->_count++;
+        }
+        
+        if( upstream )
+        {
+            IMPL::Segment & segment( this->impl->next( color ) );
+            
+            IMPL::appendUpstream( branch, segment._text );
+            
+            if( segment._text.length() < upstreamWidth + 1 )
+            {
+                segment._text.append( upstreamWidth + 1 - segment._text.length(), ' ' );
+            }
+            
+            this->impl->place( segment );
+        }
+        
+        {
+            Utility::Optional< Git::CommitInfo > commit( branch.lastCommit() );
+            
+            if( commit.hasValue() == false )
+            {
+                return;
+            }
+            
+            {
+                IMPL::Segment & segment( this->impl->next( 6 ) );
+                
+                segment._text.append( Git::OIDString( commit->oid(), 8 ).view() );
+                
+                if( this->impl->place( segment ) == false )
+                {
+                    return;
+                }
+            }
+            
+            if( commit->time() > 0 )
+            {
+                std::tm tm;
+                time_t  t( commit->time() );
+                char    date[ 64 ];
+                
+                memset( &tm, 0, sizeof( std::tm ) );
+                localtime_r( &t, &tm );
+                
+                if( strftime( date, sizeof( date ), "%x %X", &tm ) > 0 )
+                {
+                    IMPL::Segment & segment( this->impl->next( 7 ) );
+                    
+                    segment._text.append( date );
+                    
+                    if( this->impl->place( segment ) == false )
+                    {
+                        return;
+                    }
+                }
+            }
+            
+            {
+                IMPL::Segment     & segment( this->impl->next( 8 ) );
+                const std::string & author( ( commit->authorName().length() > 0 ) ? commit->authorName() : commit->committerName() );
+                
+                if( author.length() < snapshot.longestAuthor() )
+                {
+                    segment._text.append( snapshot.longestAuthor() - author.length(), ' ' );
+                }
+                
+                segment._text.append( author );
+                
+                if( this->impl->place( segment ) == false )
+                {
+                    return;
+                }
+            }
+            
+            {
+                IMPL::Segment & segment( this->impl->next( 6 ) );
+                
+                segment._text.append( commit->summary() );
+                this->impl->place( segment );
+            }
+        }
+    }
+    
+    std::size_t BranchRow::count( void ) const
+    {
+        return this->impl->_count;
+    }
+    
+    std::size_t BranchRow::x( std::size_t index ) const
+    {
+        return this->impl->_segments[ index ]._x;
+    }
+    
+    std::string_view BranchRow::text( std::size_t index ) const
+    {
+        return this->impl->_segments[ index ]._text;
+    }
+    
+    int BranchRow::color( std::size_t index ) const
+    {
+        return this->impl->_segments[ index ]._color;
+    }
+    
+    void BranchRow::IMPL::appendUpstream( const Git::BranchStatus & branch, std::string & info )
+    {
+        std::size_t ahead( 0 );
+        std::size_t behind( 0 );
+        
+        if( branch.upstream().length() == 0 )
+        {
+            return;
+        }
+        
+        branch.upstreamAheadBehind( ahead, behind );
+        
+        info.append( "[" ).append( branch.upstream() );
+        
+        if( ahead > 0 )
+        {
+            info.append( ": ahead " ).append( std::to_string( ahead ) );
+        }
+        
+        if( behind > 0 )
+        {
+            info.append( ( ahead > 0 ) ? ", behind " : ": behind " ).append( std::to_string( behind ) );
+        }
+        
+        info.append( "]" );
+    }
+    
+    BranchRow::IMPL::IMPL( void ):
+        _count( 0 ),
+        _column( 0 ),
+        _width( 0 ),
+        _full( false )
+    {}
+    
+    BranchRow::IMPL::Segment & BranchRow::IMPL::next( int color )
+    {
+        if( this->_count == this->_segments.size() )
+        {
+            this->_segments.push_back( { 0, std::string(), 0 } );
+        }
+        
+        this->_segments[ this->_count ]._x     = 0;
+        this->_segments[ this->_count ]._color = color;
+        
+        this->_segments[ this->_count ]._text.clear();
+        
+        /* Segments after the branch name are separated by a space, part of their text */
+        if( this->_count > 0 )
+        {
+            this->_segments[ this->_count ]._text.push_back( ' ' );
+        }
+        
+        return this->_segments[ this->_count ];
+    }
+    
+    bool BranchRow::IMPL::place( Segment & segment )
+    {
+        /* A segment not fitting ends the row, even if a later one would fit */
+        if( this->_full || this->_column + segment._text.length() - 1 >= this->_width )
+        {
+            this->_full = true;
+            
+            return false;
+        }
+        
+        segment._x     = this->_column;
+        this->_column += segment._text.length();
+        
+        this->_count++;
+        
+        return true;
+    }
+}
@@ -0,0 +1,75 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @header      BranchRow.hpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef UI_BRANCH_ROW_HPP
+#define UI_BRANCH_ROW_HPP
+
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <memory>
+#include "BranchStatus.hpp"
+#include "BranchSnapshot.hpp"
+
+namespace UI
+{
+    /*
+     * Formats the row of a branch into segments, each with its column and
+     * color pair, without drawing anything, so frames can be rendered or
+     * measured without a terminal. Segments are kept between calls, and
+     * their storage reused, so formatting a frame allocates little.
+     */
+    class BranchRow
+    {
+        public:
+            
+            static std::string upstreamInfo( const Git::BranchStatus & branch );
+            static std::size_t upstreamWidth( const Git::BranchSnapshot & snapshot );
+            
+            BranchRow( void );
+            BranchRow( const BranchRow & o ) = delete;
+            ~BranchRow( void );
+            
+            BranchRow & operator =( const BranchRow & o ) = delete;
+            
+            void             format( const Git::BranchStatus & branch, const Git::BranchSnapshot & snapshot, bool upstream, std::size_t upstreamWidth, std::size_t width );
+            std::size_t      count( void )              const;
+            std::size_t      x( std::size_t index )     const;
+            std::string_view text( std::size_t index )  const;
+            int              color( std::size_t index ) const;
+            
+        private:
+            
+            class IMPL;
+            
+            std::shared_ptr< IMPL > impl;
+    };
+}
+
+#endif /* UI_BRANCH_ROW_HPP */
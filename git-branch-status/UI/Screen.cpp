@@ -58,6 +58,10 @@ namespace UI
             bool                       _colors;
             std::atomic< bool >        _running;
             std::mutex                  _mtx;
+            std::size_t                _interval;
+            bool                       _updateRequested;
+            std::mutex                 _updateMtx;
+            std::condition_variable    _updateCV;
     };
     
     Screen::Screen( void ):
@@ -167,7 +171,22 @@ namespace UI
                     
                     this->refresh();
                     
-                    std::this_thread::sleep_for( std::chrono::seconds( 10 ) );
+                    /* Updates happen at the interval, if any, or when requested */
+                    {
+                        std::unique_lock< std::mutex > l( this->impl->_updateMtx );
+                        auto                           ready( [ & ] { return this->impl->_updateRequested || this->impl->_running == false; } );
+                        
+                        if( this->impl->_interval > 0 )
+                        {
+                            this->impl->_updateCV.wait_for( l, std::chrono::seconds( this->impl->_interval ), ready );
+                        }
+                        else
+                        {
+                            this->impl->_updateCV.wait( l, ready );
+                        }
+                        
+                        this->impl->_updateRequested = false;
+                    }
                 }
             }
         )
@@ -188,6 +207,8 @@ namespace UI
                 {
                     f( *( this ) );
                 }
+                
+                this->update();
             }
             
             {
@@ -222,6 +243,26 @@ namespace UI
     void Screen::stop( void )
     {
         this->impl->_running = false;
+        
+        this->impl->_updateCV.notify_all();
+    }
+    
+    void Screen::update( void )
+    {
+        {
+            std::lock_guard< std::mutex > l( this->impl->_updateMtx );
+            
+            this->impl->_updateRequested = true;
+        }
+        
+        this->impl->_updateCV.notify_all();
+    }
+    
+    void Screen::setUpdateInterval( std::size_t seconds )
+    {
+        std::lock_guard< std::mutex > l( this->impl->_updateMtx );
+        
+        this->impl->_interval = seconds;
     }
     
     void Screen::onResize( const std::function< void( const Screen & screen ) > & f )
@@ -256,13 +297,17 @@ namespace UI
         _width( 0 ),
         _height( 0 ),
         _colors( false ),
-        _running( false )
+        _running( false ),
+        _interval( 10 ),
+        _updateRequested( false )
     {}
     
     Screen::IMPL::IMPL( const IMPL & o ):
         _width( o._width.load() ),
         _height( o._height.load() ),
         _colors( o._colors ),
-        _running( false )
+        _running( false ),
+        _interval( o._interval ),
+        _updateRequested( false )
     {}
 }
@@ -57,6 +57,8 @@ namespace UI
             
             void start( void );
             void stop( void );
+            void update( void );
+            void setUpdateInterval( std::size_t seconds );
             
             void onResize( const std::function<   void( const Screen & screen ) > & f );
             void onKeyPress( const std::function< void( const Screen & screen, int key ) > & f );
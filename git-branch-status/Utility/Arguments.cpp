@@ -29,6 +29,7 @@
 
 #include "Arguments.hpp"
 #include <exception>
+#include <fstream>
 
 namespace Utility
 {
@@ -40,10 +41,21 @@ namespace Utility
             IMPL( const IMPL & o );
             ~IMPL( void );
             
-            bool        _help;
-            bool        _fetchOrigin;
-            std::string _path;
-            std::string _keychainItem;
+            bool                       _help;
+            bool                       _fetchOrigin;
+            std::vector< std::string > _paths;
+            std::string                _keychainItem;
+            size_t                     _maxWalk;
+            size_t                     _maxTime;
+            bool                       _matrix;
+            bool                       _upstream;
+            bool                       _worktrees;
+            bool                       _submodules;
+            std::vector< std::string > _matrixBranches;
+            std::vector< std::string > _includes;
+            std::vector< std::string > _excludes;
+            std::vector< std::string > _discover;
+            std::vector< std::string > _ignores;
     };
     
     static Arguments * instance = nullptr;
@@ -91,7 +103,12 @@ namespace Utility
 
     std::string Arguments::path( void ) const
     {
-        return this->impl->_path;
+        return ( this->impl->_paths.size() > 0 ) ? this->impl->_paths.front() : "";
+    }
+
+    std::vector< std::string > Arguments::paths( void ) const
+    {
+        return this->impl->_paths;
     }
 
     std::string Arguments::keychainItem( void ) const
@@ -99,6 +116,61 @@ namespace Utility
         return this->impl->_keychainItem;
     }
 
+    size_t Arguments::maxWalk( void ) const
+    {
+        return this->impl->_maxWalk;
+    }
+
+    size_t Arguments::maxTime( void ) const
+    {
+        return this->impl->_maxTime;
+    }
+
+    bool Arguments::matrix( void ) const
+    {
+        return this->impl->_matrix;
+    }
+
+    bool Arguments::upstream( void ) const
+    {
+        return this->impl->_upstream;
+    }
+
+    bool Arguments::worktrees( void ) const
+    {
+        return this->impl->_worktrees;
+    }
+
+    bool Arguments::submodules( void ) const
+    {
+        return this->impl->_submodules;
+    }
+
+    std::vector< std::string > Arguments::matrixBranches( void ) const
+    {
+        return this->impl->_matrixBranches;
+    }
+
+    std::vector< std::string > Arguments::includes( void ) const
+    {
+        return this->impl->_includes;
+    }
+
+    std::vector< std::string > Arguments::excludes( void ) const
+    {
+        return this->impl->_excludes;
+    }
+
+    std::vector< std::string > Arguments::discover( void ) const
+    {
+        return this->impl->_discover;
+    }
+
+    std::vector< std::string > Arguments::ignores( void ) const
+    {
+        return this->impl->_ignores;
+    }
+
     void swap( Arguments & o1, Arguments & o2 )
     {
         using std::swap;
@@ -108,7 +180,13 @@ namespace Utility
 
     Arguments::IMPL::IMPL( int argc, char * argv[] ):
         _help( false ),
-        _fetchOrigin( false )
+        _fetchOrigin( false ),
+        _maxWalk( 0 ),
+        _maxTime( 0 ),
+        _matrix( false ),
+        _upstream( false ),
+        _worktrees( false ),
+        _submodules( false )
     {
         for( int i = 1; i < argc; i++ )
         {
@@ -127,11 +205,123 @@ namespace Utility
                     this->_keychainItem = argv[ ++i ];
                 }
             }
+            else if( std::string( argv[ i ] ) == "--matrix" )
+            {
+                this->_matrix = true;
+            }
+            else if( std::string( argv[ i ] ) == "--upstream" )
+            {
+                this->_upstream = true;
+            }
+            else if( std::string( argv[ i ] ) == "--worktrees" )
+            {
+                this->_worktrees = true;
+            }
+            else if( std::string( argv[ i ] ) == "--submodules" )
+            {
+                this->_submodules = true;
+            }
+            else if( std::string( argv[ i ] ) == "--matrix-branches" )
+            {
+                if( i + 1 < argc )
+                {
+                    std::string list( argv[ ++i ] );
+                    size_t      start( 0 );
+                    
+                    this->_matrix = true;
+                    
+                    while( start <= list.size() )
+                    {
+                        size_t end( list.find( ',', start ) );
+                        
+                        if( end == std::string::npos )
+                        {
+                            end = list.size();
+                        }
+                        
+                        if( end > start )
+                        {
+                            this->_matrixBranches.push_back( list.substr( start, end - start ) );
+                        }
+                        
+                        start = end + 1;
+                    }
+                }
+            }
+            else if( std::string( argv[ i ] ) == "--path-list" )
+            {
+                if( i + 1 < argc )
+                {
+                    std::ifstream file( argv[ ++i ] );
+                    std::string   line;
+                    
+                    /* One path per line, with blank lines and comments ignored */
+                    while( std::getline( file, line ) )
+                    {
+                        line.erase( 0, line.find_first_not_of( " \t" ) );
+                        line.erase( line.find_last_not_of( " \t\r" ) + 1 );
+                        
+                        if( line.length() > 0 && line[ 0 ] != '#' )
+                        {
+                            this->_paths.push_back( line );
+                        }
+                    }
+                }
+            }
+            else if( std::string( argv[ i ] ) == "--discover" )
+            {
+                if( i + 1 < argc )
+                {
+                    this->_discover.push_back( argv[ ++i ] );
+                }
+            }
+            else if( std::string( argv[ i ] ) == "--ignore" )
+            {
+                if( i + 1 < argc )
+                {
+                    this->_ignores.push_back( argv[ ++i ] );
+                }
+            }
+            else if( std::string( argv[ i ] ) == "--include" )
+            {
+                if( i + 1 < argc )
+                {
+                    this->_includes.push_back( argv[ ++i ] );
+                }
+            }
+            else if( std::string( argv[ i ] ) == "--exclude" )
+            {
+                if( i + 1 < argc )
+                {
+                    this->_excludes.push_back( argv[ ++i ] );
+                }
+            }
+            else if( std::string( argv[ i ] ) == "--max-walk" || std::string( argv[ i ] ) == "--max-time" )
+            {
+                if( i + 1 < argc )
+                {
+                    size_t value( 0 );
+                    
+                    try
+                    {
+                        value = std::stoul( argv[ i + 1 ] );
+                    }
+                    catch( ... )
+                    {}
+                    
+                    if( std::string( argv[ i++ ] ) == "--max-walk" )
+                    {
+                        this->_maxWalk = value;
+                    }
+                    else
+                    {
+                        this->_maxTime = value;
+                    }
+                }
+            }
             else
             {
-                this->_path = argv[ i ];
-                
-                break;
+                this->_paths.push_back( argv[ i ] );
             }
         }
     }
@@ -139,8 +329,19 @@ namespace Utility
     Arguments::IMPL::IMPL( const IMPL & o ):
         _help( o._help ),
         _fetchOrigin( o._fetchOrigin ),
-        _path( o._path ),
-        _keychainItem( o._keychainItem )
+        _paths( o._paths ),
+        _keychainItem( o._keychainItem ),
+        _maxWalk( o._maxWalk ),
+        _maxTime( o._maxTime ),
+        _matrix( o._matrix ),
+        _upstream( o._upstream ),
+        _worktrees( o._worktrees ),
+        _submodules( o._submodules ),
+        _matrixBranches( o._matrixBranches ),
+        _includes( o._includes ),
+        _excludes( o._excludes ),
+        _discover( o._discover ),
+        _ignores( o._ignores )
     {}
 
     Arguments::IMPL::~IMPL( void )
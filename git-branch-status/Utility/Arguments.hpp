@@ -32,6 +32,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace Utility
 {
@@ -47,10 +48,22 @@ namespace Utility
             
             Arguments & operator =( Arguments o );
             
-            bool        help( void )          const;
-            bool        fetchOrigin( void )   const;
-            std::string path( void )          const;
-            std::string keychainItem( void )  const;
+            bool                       help( void )           const;
+            bool                       fetchOrigin( void )    const;
+            std::string                path( void )           const;
+            std::vector< std::string > paths( void )          const;
+            std::string                keychainItem( void )   const;
+            size_t                     maxWalk( void )        const;
+            size_t                     maxTime( void )        const;
+            bool                       matrix( void )         const;
+            bool                       upstream( void )       const;
+            bool                       worktrees( void )      const;
+            bool                       submodules( void )     const;
+            std::vector< std::string > matrixBranches( void ) const;
+            std::vector< std::string > includes( void )       const;
+            std::vector< std::string > excludes( void )       const;
+            std::vector< std::string > discover( void )       const;
+            std::vector< std::string > ignores( void )        const;
             
             friend void swap( Arguments & o1, Arguments & o2 );
             
@@ -0,0 +1,133 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @header      LRUCache.hpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#ifndef UTILITY_LRU_CACHE_HPP
+#define UTILITY_LRU_CACHE_HPP
+
+#include <list>
+#include <mutex>
+#include <utility>
+#include <functional>
+#include <unordered_map>
+#include "Optional.hpp"
+
+namespace Utility
+{
+    template< typename _K_, typename _V_, typename _H_ = std::hash< _K_ >, typename _E_ = std::equal_to< _K_ > >
+    class LRUCache
+    {
+        public:
+            
+            LRUCache( size_t capacity ):
+                _capacity( capacity )
+            {}
+            
+            LRUCache( const LRUCache & o ) = delete;
+            LRUCache & operator =( const LRUCache & o ) = delete;
+            
+            size_t size( void ) const
+            {
+                std::lock_guard< std::mutex > l( this->_mtx );
+                
+                return this->_map.size();
+            }
+            
+            Optional< _V_ > get( const _K_ & key )
+            {
+                std::lock_guard< std::mutex > l( this->_mtx );
+                
+                if( this->_map.count( key ) == 0 )
+                {
+                    return {};
+                }
+                
+                {
+                    auto it( this->_map[ key ] );
+                    
+                    this->_list.splice( this->_list.begin(), this->_list, it );
+                    
+                    return it->second;
+                }
+            }
+            
+            void set( const _K_ & key, const _V_ & value )
+            {
+                std::lock_guard< std::mutex > l( this->_mtx );
+                
+                if( this->_map.count( key ) > 0 )
+                {
+                    auto it( this->_map[ key ] );
+                    
+                    it->second = value;
+                    
+                    this->_list.splice( this->_list.begin(), this->_list, it );
+                    
+                    return;
+                }
+                
+                this->_list.emplace_front( key, value );
+                
+                this->_map[ key ] = this->_list.begin();
+                
+                while( this->_map.size() > this->_capacity && this->_list.empty() == false )
+                {
+                    this->_map.erase( this->_list.back().first );
+                    this->_list.pop_back();
+                }
+            }
+            
+            /* Most recently used entries come first */
+            void forEach( const std::function< void( const _K_ & key, const _V_ & value ) > & f ) const
+            {
+                std::lock_guard< std::mutex > l( this->_mtx );
+                
+                for( const auto & p: this->_list )
+                {
+                    f( p.first, p.second );
+                }
+            }
+            
+            void clear( void )
+            {
+                std::lock_guard< std::mutex > l( this->_mtx );
+                
+                this->_map.clear();
+                this->_list.clear();
+            }
+            
+        private:
+            
+            size_t                                                                                     _capacity;
+            mutable std::mutex                                                                         _mtx;
+            std::list< std::pair< _K_, _V_ > >                                                         _list;
+            std::unordered_map< _K_, typename std::list< std::pair< _K_, _V_ > >::iterator, _H_, _E_ > _map;
+    };
+}
+
+#endif /* UTILITY_LRU_CACHE_HPP */
@@ -0,0 +1,270 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @file        ThreadPool.cpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <exception>
+#include <condition_variable>
+
+/*
+ * Each worker owns a queue. Tasks of a batch are dealt round-robin to the
+ * queues; a worker takes tasks from the front of its own queue and, once
+ * empty, steals from the back of the others. Tasks receive the index of
+ * the worker running them, so callers can keep per-worker state.
+ * Batches from different callers share the queues, each batch tracking
+ * its own completion, so a caller only waits for its own tasks. The first
+ * exception thrown by a task of a batch is rethrown to its caller.
+ */
+
+namespace Utility
+{
+    class ThreadPool::IMPL
+    {
+        public:
+            
+            class Batch
+            {
+                public:
+                    
+                    Batch( size_t count );
+                    
+                    std::atomic< size_t >   _remaining;
+                    std::mutex              _mtx;
+                    std::condition_variable _finished;
+                    std::exception_ptr      _error;
+            };
+            
+            class Task
+            {
+                public:
+                    
+                    std::function< void( size_t ) > _function;
+                    std::shared_ptr< Batch >        _batch;
+            };
+            
+            class Queue
+            {
+                public:
+                    
+                    std::deque< Task > _tasks;
+                    std::mutex         _mtx;
+            };
+            
+            IMPL( size_t count );
+            ~IMPL( void );
+            
+            void work( size_t worker );
+            bool take( size_t worker, Task & task );
+            
+            std::vector< std::thread >              _threads;
+            std::vector< std::unique_ptr< Queue > > _queues;
+            std::mutex                              _mtx;
+            std::condition_variable                 _available;
+            std::atomic< size_t >                   _queued;
+            bool                                    _stop;
+    };
+    
+    ThreadPool & ThreadPool::shared( void )
+    {
+        static ThreadPool * pool( new ThreadPool( std::max( std::thread::hardware_concurrency(), 1U ) ) );
+        
+        return *( pool );
+    }
+    
+    ThreadPool::ThreadPool( size_t count ): impl( std::make_shared< IMPL >( count ) )
+    {}
+    
+    ThreadPool::~ThreadPool( void )
+    {}
+    
+    size_t ThreadPool::count( void ) const
+    {
+        return this->impl->_threads.size();
+    }
+    
+    void ThreadPool::run( const std::vector< std::function< void( size_t worker ) > > & tasks )
+    {
+        std::shared_ptr< IMPL::Batch > batch;
+        
+        if( tasks.size() == 0 )
+        {
+            return;
+        }
+        
+        batch = std::make_shared< IMPL::Batch >( tasks.size() );
+        
+        for( size_t i = 0; i < tasks.size(); i++ )
+        {
+            IMPL::Queue                 & queue( *( this->impl->_queues[ i % this->impl->_queues.size() ] ) );
+            std::lock_guard< std::mutex > l( queue._mtx );
+            
+            this->impl->_queued++;
+            
+            queue._tasks.push_back( { tasks[ i ], batch } );
+        }
+        
+        {
+            std::lock_guard< std::mutex > l( this->impl->_mtx );
+            
+            this->impl->_available.notify_all();
+        }
+        
+        {
+            std::unique_lock< std::mutex > l( batch->_mtx );
+            
+            batch->_finished.wait( l, [ & ] { return batch->_remaining == 0; } );
+        }
+        
+        if( batch->_error != nullptr )
+        {
+            std::rethrow_exception( batch->_error );
+        }
+    }
+    
+    ThreadPool::IMPL::Batch::Batch( size_t count ):
+        _remaining( count )
+    {}
+    
+    ThreadPool::IMPL::IMPL( size_t count ):
+        _queued( 0 ),
+        _stop( false )
+    {
+        count = std::max< size_t >( count, 1 );
+        
+        for( size_t i = 0; i < count; i++ )
+        {
+            this->_queues.push_back( std::make_unique< Queue >() );
+        }
+        
+        for( size_t i = 0; i < count; i++ )
+        {
+            this->_threads.push_back( std::thread( [ = ] { this->work( i ); } ) );
+        }
+    }
+    
+    ThreadPool::IMPL::~IMPL( void )
+    {
+        {
+            std::lock_guard< std::mutex > l( this->_mtx );
+            
+            this->_stop = true;
+        }
+        
+        this->_available.notify_all();
+        
+        for( auto & thread: this->_threads )
+        {
+            thread.join();
+        }
+    }
+    
+    void ThreadPool::IMPL::work( size_t worker )
+    {
+        while( true )
+        {
+            Task task;
+            
+            {
+                std::unique_lock< std::mutex > l( this->_mtx );
+                
+                this->_available.wait( l, [ & ] { return this->_stop || this->_queued > 0; } );
+                
+                if( this->_stop )
+                {
+                    return;
+                }
+            }
+            
+            while( this->take( worker, task ) )
+            {
+                std::shared_ptr< Batch > batch( std::move( task._batch ) );
+                
+                try
+                {
+                    task._function( worker );
+                }
+                catch( ... )
+                {
+                    std::lock_guard< std::mutex > l( batch->_mtx );
+                    
+                    if( batch->_error == nullptr )
+                    {
+                        batch->_error = std::current_exception();
+                    }
+                }
+                
+                task._function = nullptr;
+                
+                if( --( batch->_remaining ) == 0 )
+                {
+                    std::lock_guard< std::mutex > l( batch->_mtx );
+                    
+                    batch->_finished.notify_all();
+                }
+            }
+        }
+    }
+    
+    bool ThreadPool::IMPL::take( size_t worker, Task & task )
+    {
+        for( size_t i = 0; i < this->_queues.size(); i++ )
+        {
+            Queue                       & queue( *( this->_queues[ ( worker + i ) % this->_queues.size() ] ) );
+            std::lock_guard< std::mutex > l( queue._mtx );
+            
+            if( queue._tasks.size() == 0 )
+            {
+                continue;
+            }
+            
+            if( i == 0 )
+            {
+                task = std::move( queue._tasks.front() );
+                
+                queue._tasks.pop_front();
+            }
+            else
+            {
+                task = std::move( queue._tasks.back() );
+                
+                queue._tasks.pop_back();
+            }
+            
+            this->_queued--;
+            
+            return true;
+        }
+        
+        return false;
+    }
+}
@@ -0,0 +1,407 @@
+/*******************************************************************************
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2021 Jean-David Gadina - www-xs-labs.com
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+/*!
+ * @file        Watcher.cpp
+ * @copyright   (c) 2021, Jean-David Gadina - www.xs-labs.com
+ */
+
+#include "Watcher.hpp"
+#include <map>
+#include <set>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <unistd.h>
+#include <dirent.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <algorithm>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+/*
+ * Watches directories for changed entries, either some files of a
+ * directory or a whole tree, and calls back once a burst of changes is
+ * over. Git updates files by writing a .lock file and renaming it, so
+ * lock files are ignored and renames count as changes.
+ * Linux uses inotify; other systems, or Linux when inotify isn't available,
+ * poll the modification times of the watched entries, which is cheap as
+ * only directories and a few files are checked.
+ */
+
+namespace Utility
+{
+    class Watcher::IMPL
+    {
+        public:
+            
+            class Watch
+            {
+                public:
+                    
+                    std::string             _directory;
+                    std::set< std::string > _names;
+                    bool                    _tree;
+            };
+            
+            static constexpr int quietMilliseconds = 150;
+            static constexpr int maxMilliseconds   = 1000;
+            static constexpr int pollMilliseconds  = 500;
+            
+            IMPL( void );
+            ~IMPL( void );
+            
+            void add( const std::string & directory, const std::set< std::string > & names, bool tree );
+            bool matches( const Watch & watch, const std::string & name ) const;
+            bool changed( int timeout );
+            bool notified( int timeout );
+            bool polled( int timeout );
+            void run( void );
+            void signature( const std::string & directory, const std::set< std::string > & names, bool tree, std::map< std::string, struct timespec > & times ) const;
+            
+            int                                          _fd;
+            std::map< int, Watch >                       _watches;
+            std::vector< Watch >                         _roots;
+            std::map< std::string, struct timespec >     _times;
+            std::vector< std::function< void( void ) > > _onChange;
+            std::thread                                  _thread;
+            std::atomic< bool >                          _running;
+            std::recursive_mutex                         _mtx;
+    };
+    
+    Watcher::Watcher( void ): impl( std::make_shared< IMPL >() )
+    {}
+    
+    Watcher::~Watcher( void )
+    {
+        this->stop();
+    }
+    
+    void Watcher::watchFiles( const std::string & directory, const std::vector< std::string > & names )
+    {
+        this->impl->add( directory, std::set< std::string >( names.begin(), names.end() ), false );
+    }
+    
+    void Watcher::watchTree( const std::string & directory )
+    {
+        this->impl->add( directory, {}, true );
+    }
+    
+    void Watcher::onChange( const std::function< void( void ) > & f )
+    {
+        std::lock_guard< std::recursive_mutex > l( this->impl->_mtx );
+        
+        this->impl->_onChange.push_back( f );
+    }
+    
+    void Watcher::start( void )
+    {
+        if( this->impl->_running )
+        {
+            return;
+        }
+        
+        this->impl->_running = true;
+        this->impl->_thread  = std::thread( [ this ] { this->impl->run(); } );
+    }
+    
+    void Watcher::stop( void )
+    {
+        this->impl->_running = false;
+        
+        if( this->impl->_thread.joinable() )
+        {
+            this->impl->_thread.join();
+        }
+    }
+    
+    Watcher::IMPL::IMPL( void ):
+        _fd( -1 ),
+        _running( false )
+    {
+        #ifdef __linux__
+        this->_fd = inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+        #endif
+    }
+    
+    Watcher::IMPL::~IMPL( void )
+    {
+        if( this->_fd >= 0 )
+        {
+            close( this->_fd );
+        }
+    }
+    
+    void Watcher::IMPL::add( const std::string & directory, const std::set< std::string > & names, bool tree )
+    {
+        std::lock_guard< std::recursive_mutex > l( this->_mtx );
+        Watch                                   watch;
+        
+        watch._directory = directory;
+        watch._names     = names;
+        watch._tree      = tree;
+        
+        if( this->_fd < 0 )
+        {
+            this->_roots.push_back( watch );
+            this->signature( directory, names, tree, this->_times );
+            
+            return;
+        }
+        
+        #ifdef __linux__
+        {
+            int wd( inotify_add_watch( this->_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE | IN_DELETE_SELF | IN_ONLYDIR ) );
+            
+            if( wd < 0 )
+            {
+                return;
+            }
+            
+            if( this->_watches.count( wd ) > 0 )
+            {
+                this->_watches[ wd ]._tree = this->_watches[ wd ]._tree || tree;
+                
+                this->_watches[ wd ]._names.insert( names.begin(), names.end() );
+            }
+            else
+            {
+                this->_watches[ wd ] = watch;
+            }
+        }
+        #endif
+        
+        if( tree )
+        {
+            DIR * dir( opendir( directory.c_str() ) );
+            
+            if( dir != nullptr )
+            {
+                struct dirent * e( nullptr );
+                
+                while( ( e = readdir( dir ) ) != nullptr )
+                {
+                    std::string path( directory + "/" + e->d_name );
+                    struct stat st;
+                    
+                    if( e->d_name[ 0 ] == '.' || stat( path.c_str(), &st ) != 0 || S_ISDIR( st.st_mode ) == false )
+                    {
+                        continue;
+                    }
+                    
+                    this->add( path, {}, true );
+                }
+                
+                closedir( dir );
+            }
+        }
+    }
+    
+    bool Watcher::IMPL::matches( const Watch & watch, const std::string & name ) const
+    {
+        if( name.length() > 5 && name.compare( name.length() - 5, 5, ".lock" ) == 0 )
+        {
+            return false;
+        }
+        
+        return watch._tree || watch._names.count( name ) > 0;
+    }
+    
+    bool Watcher::IMPL::changed( int timeout )
+    {
+        return ( this->_fd < 0 ) ? this->polled( timeout ) : this->notified( timeout );
+    }
+    
+    bool Watcher::IMPL::notified( int timeout )
+    {
+        struct pollfd p;
+        bool          changed( false );
+        
+        memset( &p, 0, sizeof( p ) );
+        
+        p.fd     = this->_fd;
+        p.events = POLLIN;
+        
+        if( poll( &p, 1, timeout ) <= 0 )
+        {
+            return false;
+        }
+        
+        #ifdef __linux__
+        {
+            alignas( struct inotify_event ) char buffer[ 4096 ];
+            ssize_t                              length( 0 );
+            
+            while( ( length = read( this->_fd, buffer, sizeof( buffer ) ) ) > 0 )
+            {
+                std::lock_guard< std::recursive_mutex > l( this->_mtx );
+                
+                for( ssize_t i = 0; i < length; )
+                {
+                    const struct inotify_event * event( reinterpret_cast< const struct inotify_event * >( buffer + i ) );
+                    std::string                  name( ( event->len > 0 ) ? event->name : "" );
+                    auto                         it( this->_watches.find( event->wd ) );
+                    
+                    i += static_cast< ssize_t >( sizeof( struct inotify_event ) + event->len );
+                    
+                    if( event->mask & IN_Q_OVERFLOW )
+                    {
+                        changed = true;
+                    }
+                    else if( event->mask & IN_IGNORED )
+                    {
+                        this->_watches.erase( event->wd );
+                    }
+                    else if( it != this->_watches.end() )
+                    {
+                        /* New directories of a tree are watched too, as refs may be created in them right away */
+                        if( ( event->mask & IN_CREATE ) && ( event->mask & IN_ISDIR ) && it->second._tree )
+                        {
+                            this->add( it->second._directory + "/" + name, {}, true );
+                            
+                            changed = true;
+                        }
+                        else if( ( event->mask & IN_CREATE ) == 0 && this->matches( it->second, name ) )
+                        {
+                            changed = true;
+                        }
+                    }
+                }
+            }
+        }
+        #endif
+        
+        return changed;
+    }
+    
+    bool Watcher::IMPL::polled( int timeout )
+    {
+        std::map< std::string, struct timespec > times;
+        
+        std::this_thread::sleep_for( std::chrono::milliseconds( timeout ) );
+        
+        std::lock_guard< std::recursive_mutex > l( this->_mtx );
+        
+        for( const auto & root: this->_roots )
+        {
+            this->signature( root._directory, root._names, root._tree, times );
+        }
+        
+        if( times.size() == this->_times.size() && std::equal( times.begin(), times.end(), this->_times.begin(), []( const auto & t1, const auto & t2 ) { return t1.first == t2.first && t1.second.tv_sec == t2.second.tv_sec && t1.second.tv_nsec == t2.second.tv_nsec; } ) )
+        {
+            return false;
+        }
+        
+        this->_times = times;
+        
+        return true;
+    }
+    
+    void Watcher::IMPL::run( void )
+    {
+        while( this->_running )
+        {
+            if( this->changed( pollMilliseconds ) == false )
+            {
+                continue;
+            }
+            
+            /* Changes come in bursts, like during a fetch, which are reported once they are over */
+            {
+                auto start( std::chrono::steady_clock::now() );
+                
+                while( this->_running && std::chrono::steady_clock::now() - start < std::chrono::milliseconds( maxMilliseconds ) )
+                {
+                    if( this->changed( quietMilliseconds ) == false )
+                    {
+                        break;
+                    }
+                }
+            }
+            
+            {
+                std::lock_guard< std::recursive_mutex > l( this->_mtx );
+                
+                for( const auto & f: this->_onChange )
+                {
+                    f();
+                }
+            }
+        }
+    }
+    
+    void Watcher::IMPL::signature( const std::string & directory, const std::set< std::string > & names, bool tree, std::map< std::string, struct timespec > & times ) const
+    {
+        struct stat st;
+        
+        if( stat( directory.c_str(), &st ) != 0 )
+        {
+            return;
+        }
+        
+        #ifdef __APPLE__
+        times[ directory ] = st.st_mtimespec;
+        #else
+        times[ directory ] = st.st_mtim;
+        #endif
+        
+        for( const auto & name: names )
+        {
+            if( stat( ( directory + "/" + name ).c_str(), &st ) == 0 )
+            {
+                #ifdef __APPLE__
+                times[ directory + "/" + name ] = st.st_mtimespec;
+                #else
+                times[ directory + "/" + name ] = st.st_mtim;
+                #endif
+            }
+        }
+        
+        if( tree )
+        {
+            DIR * dir( opendir( directory.c_str() ) );
+            
+            if( dir != nullptr )
+            {
+                struct dirent * e( nullptr );
+                
+                while( ( e = readdir( dir ) ) != nullptr )
+                {
+                    std::string path( directory + "/" + e->d_name );
+                    
+                    if( e->d_name[ 0 ] != '.' && stat( path.c_str(), &st ) == 0 && S_ISDIR( st.st_mode ) )
+                    {
+                        this->signature( path, {}, true, times );
+                    }
+                }
+                
+                closedir( dir );
+            }
+        }
+    }
+}
@@ -29,14 +29,29 @@
 
 #include <stdexcept>
 #include <iostream>
-#include <iomanip>
-#include <sstream>
+#include <memory>
+#include <set>
+#include <thread>
+#include <mutex>
 #include <ncurses.h>
 #include "Arguments.hpp"
 #include "Git/Repository.hpp"
+#include "Git/Dashboard.hpp"
+#include "Git/Discovery.hpp"
+#include "Git/OID.hpp"
 #include "UI/Screen.hpp"
+#include "UI/BranchRow.hpp"
+#include "Watcher.hpp"
 
-static void printBranchInfo( const Git::Branch & branch, const Git::Repository & repos, const UI::Screen & screen, unsigned int y );
+static constexpr size_t dashboardThreads = 4;
+
+static void initColors( const UI::Screen & screen );
+static void printBranchInfo( const Git::BranchStatus & branch, const Git::BranchSnapshot & snapshot, size_t upstreamWidth, UI::BranchRow & row, const UI::Screen & screen, unsigned int y );
+static void printWorktree( const Git::Worktree & worktree, const UI::Screen & screen, unsigned int y );
+static void printDashboard( const std::vector< Git::RepositoryStatus > & repositories, const UI::Screen & screen );
+static std::vector< size_t > visibleSubmodules( const std::vector< Git::Submodule > & submodules, const std::set< std::string > & collapsed );
+static void printSubmodules( const std::vector< Git::Submodule > & submodules, const std::set< std::string > & collapsed, size_t selected, const UI::Screen & screen );
+static void printMatrix( const Git::Repository & repos, const std::vector< std::string > & names, const UI::Screen & screen );
 static void showHelp( void );
 
 int main( int argc, char * argv[] )
@@ -51,7 +66,22 @@ int main( int argc, char * argv[] )
     }
     
     {
-        UI::Screen screen;
+        UI::Screen                               screen;
+        Git::History                             history;
+        Utility::Watcher                         watcher;
+        std::unique_ptr< Git::Repository >       repos;
+        std::unique_ptr< Git::Dashboard >        dashboard;
+        std::unique_ptr< Git::Discovery >        discovery;
+        std::vector< std::string >               paths( args.paths() );
+        std::vector< std::string >               discovered;
+        std::thread                              crawler;
+        std::mutex                               crawlerMtx;
+        Utility::Optional< Git::BranchSnapshot > snapshot;
+        UI::BranchRow                            row;
+        std::vector< Git::Submodule >            submodules;
+        std::set< std::string >                  collapsed;
+        size_t                                   selected( 0 );
+        bool                                     moved( false );
         
         screen.onKeyPress
         (
@@ -61,6 +91,44 @@ int main( int argc, char * argv[] )
                 {
                     screen.stop();
                 }
+                else if( args.submodules() )
+                {
+                    std::vector< size_t > visible( visibleSubmodules( submodules, collapsed ) );
+                    
+                    if( visible.size() == 0 )
+                    {
+                        return;
+                    }
+                    
+                    selected = std::min( selected, visible.size() - 1 );
+                    
+                    if( key == KEY_UP && selected > 0 )
+                    {
+                        selected--;
+                    }
+                    else if( key == KEY_DOWN && selected + 1 < visible.size() )
+                    {
+                        selected++;
+                    }
+                    else if( key == ' ' || key == '\n' || key == KEY_ENTER )
+                    {
+                        std::string path( submodules[ visible[ selected ] ].path() );
+                        
+                        if( collapsed.erase( path ) == 0 )
+                        {
+                            collapsed.insert( path );
+                        }
+                    }
+                    else
+                    {
+                        return;
+                    }
+                    
+                    /* The tree is only drawn again, its submodules are not evaluated */
+                    moved = true;
+                    
+                    screen.update();
+                }
             }
         );
         
@@ -70,13 +138,42 @@ int main( int argc, char * argv[] )
             {
                 try
                 {
-                    Git::Repository                  repos( ( args.path().length() > 0 ) ? args.path() : "." );
-                    Utility::Optional< Git::Branch > head( repos.head() );
-                    int                          y( 0 );
+                    int           y( 0 );
+                    Git::RefDelta delta;
+                    
+                    /* Many repositories are monitored together, on a summary screen */
+                    if( dashboard != nullptr )
+                    {
+                        {
+                            std::lock_guard< std::mutex > l( crawlerMtx );
+                            
+                            if( discovered.size() > 0 )
+                            {
+                                dashboard->setPaths( discovered );
+                                discovered.clear();
+                            }
+                        }
+                        
+                        printDashboard( dashboard->update(), screen );
+                        
+                        return;
+                    }
+                    
+                    /* The repository is kept open across updates, so only its branches are listed again */
+                    if( repos == nullptr )
+                    {
+                        repos = std::make_unique< Git::Repository >( ( args.path().length() > 0 ) ? args.path() : ".", history );
+                        
+                        repos->watch( watcher );
+                    }
+                    else
+                    {
+                        delta = repos->refresh();
+                    }
                     
                     if( args.fetchOrigin() )
                     {
-                        for( const auto & remote: repos.remotes() )
+                        for( const auto & remote: repos->remotes() )
                         {
                             if( remote.name() == "origin" )
                             {
@@ -85,39 +182,71 @@ int main( int argc, char * argv[] )
                         }
                     }
                     
-                    if( head.hasValue() == false )
+                    if( args.submodules() )
                     {
-                        throw std::runtime_error( "Cannot get head" );
+                        if( moved == false || submodules.size() == 0 )
+                        {
+                            submodules = repos->submodules();
+                        }
+                        
+                        moved = false;
+                        
+                        printSubmodules( submodules, collapsed, selected, screen );
+                        
+                        return;
                     }
                     
-                    printBranchInfo( *( head ), repos, screen, y++ );
+                    if( args.matrix() )
+                    {
+                        printMatrix( *( repos ), args.matrixBranches(), screen );
+                        
+                        return;
+                    }
                     
                     {
-                        std::vector< Git::Branch > branches( repos.branches()  );
+                        size_t upstreamWidth( 0 );
+                        
+                        /* The previous snapshot is kept while no ref moved, except for upstreams, as the config may change */
+                        if( snapshot.hasValue() == false || delta.isEmpty() == false || args.upstream() )
+                        {
+                            snapshot = Utility::Optional< Git::BranchSnapshot >( repos->snapshot() );
+                        }
+                        
+                        if( snapshot->head().hasValue() == false && args.worktrees() == false )
+                        {
+                            throw std::runtime_error( "Cannot get head" );
+                        }
+                        
+                        if( args.upstream() )
+                        {
+                            upstreamWidth = UI::BranchRow::upstreamWidth( *( snapshot ) );
+                        }
                         
-                        std::sort
-                        (
-                            std::begin( branches ),
-                            std::end( branches ),
-                            [ & ]( const Git::Branch & b1, const Git::Branch & b2 )
+                        /* Worktrees are grouped, each with the status of its HEAD */
+                        if( args.worktrees() )
+                        {
+                            for( const auto & worktree: repos->worktrees( *( snapshot ) ) )
                             {
-                                if( b1.name() == "origin/" + head->name() )
+                                if( y + 1 >= static_cast< int >( screen.height() ) )
                                 {
-                                    return true;
+                                    break;
                                 }
                                 
-                                return b1.name() < b2.name();
+                                printWorktree( worktree, screen, y++ );
+                                printBranchInfo( worktree.status(), *( snapshot ), upstreamWidth, row, screen, y++ );
                             }
-                        );
+                            
+                            return;
+                        }
                         
-                        for( const auto & branch: branches )
+                        for( const auto & branch: snapshot->branches() )
                         {
-                            if( branch == head )
+                            if( y >= static_cast< int >( screen.height() ) )
                             {
-                                continue;
+                                break;
                             }
                             
-                            printBranchInfo( branch, repos, screen, y++ );
+                            printBranchInfo( branch, *( snapshot ), upstreamWidth, row, screen, y++ );
                         }
                     }
                 }
@@ -130,216 +259,514 @@ int main( int argc, char * argv[] )
             }
         );
         
+        /* Refs are watched, so periodic updates are only needed to fetch */
+        watcher.onChange( [ & ] { screen.update(); } );
+        watcher.start();
+        screen.setUpdateInterval( ( args.fetchOrigin() ) ? 10 : 0 );
+        
+        /*
+         * Repositories found by a previous run are shown right away, while
+         * the tree is crawled again in the background. Without a cache, the
+         * crawl has to complete first.
+         */
+        if( args.discover().size() > 0 )
+        {
+            std::vector< std::string > ignores( Git::Discovery::defaultIgnores() );
+            std::vector< std::string > found;
+            
+            for( const auto & ignore: args.ignores() )
+            {
+                ignores.push_back( ignore );
+            }
+            
+            discovery = std::make_unique< Git::Discovery >( args.discover(), ignores );
+            found     = discovery->cached();
+            
+            if( found.size() == 0 )
+            {
+                found = discovery->crawl();
+            }
+            else
+            {
+                crawler = std::thread
+                (
+                    [ & ]
+                    {
+                        std::vector< std::string > crawled( args.paths() );
+                        std::vector< std::string > found( discovery->crawl() );
+                        
+                        crawled.insert( crawled.end(), found.begin(), found.end() );
+                        
+                        {
+                            std::lock_guard< std::mutex > l( crawlerMtx );
+                            
+                            discovered = crawled;
+                        }
+                        
+                        screen.update();
+                    }
+                );
+            }
+            
+            paths.insert( paths.end(), found.begin(), found.end() );
+        }
+        
+        /* The dashboard schedules its own refreshes, so it is updated every second */
+        if( paths.size() > 1 || discovery != nullptr )
+        {
+            dashboard = std::make_unique< Git::Dashboard >( paths, dashboardThreads );
+            
+            screen.setUpdateInterval( 1 );
+        }
+        
         screen.start();
+        watcher.stop();
+        
+        /* A crawl of a large tree may take minutes, so it is stopped rather than awaited */
+        if( crawler.joinable() )
+        {
+            discovery->stop();
+            crawler.join();
+        }
     }
     
     return EXIT_SUCCESS;
 }
 
-void printBranchInfo( const Git::Branch & branch, const Git::Repository & repos, const UI::Screen & screen, unsigned int y )
+void initColors( const UI::Screen & screen )
 {
-    std::string        symbol;
-    unsigned long long attr( 0 );
-    
-    if( screen.width() < 10 )
+    if( screen.supportsColors() )
+    {
+        ::init_pair( 1, COLOR_GREEN,   COLOR_BLACK );
+        ::init_pair( 2, COLOR_GREEN,   COLOR_BLACK );
+        ::init_pair( 3, COLOR_BLUE,    COLOR_BLACK );
+        ::init_pair( 4, COLOR_RED,     COLOR_BLACK );
+        ::init_pair( 5, COLOR_MAGENTA, COLOR_BLACK );
+        ::init_pair( 6, COLOR_YELLOW,  COLOR_BLACK );
+        ::init_pair( 7, COLOR_CYAN,    COLOR_BLACK );
+        ::init_pair( 8, COLOR_WHITE,   COLOR_BLACK );
+    }
+}
+
+void printBranchInfo( const Git::BranchStatus & branch, const Git::BranchSnapshot & snapshot, size_t upstreamWidth, UI::BranchRow & row, const UI::Screen & screen, unsigned int y )
+{
+    if( y >= screen.height() )
     {
         return;
     }
     
-    if( y >= screen.height() )
+    initColors( screen );
+    row.format( branch, snapshot, Utility::Arguments::sharedInstance().upstream(), upstreamWidth, screen.width() );
+    
+    for( size_t i = 0; i < row.count(); i++ )
+    {
+        std::string_view text( row.text( i ) );
+        
+        ::move( y, static_cast< int >( row.x( i ) ) );
+        ::attron( COLOR_PAIR( row.color( i ) ) );
+        ::printw( "%.*s", static_cast< int >( text.length() ), text.data() );
+        ::attroff( COLOR_PAIR( row.color( i ) ) );
+    }
+}
+
+void printWorktree( const Git::Worktree & worktree, const UI::Screen & screen, unsigned int y )
+{
+    std::string info( worktree.path() );
+    
+    if( screen.width() < 10 || y >= screen.height() )
     {
         return;
     }
     
+    if( worktree.isMain() == false )
+    {
+        info += " [" + worktree.name() + "]";
+    }
+    
+    if( worktree.isCurrent() )
+    {
+        info += " *";
+    }
+    
+    if( info.length() > screen.width() )
+    {
+        info = info.substr( 0, screen.width() );
+    }
+    
     ::move( y, 0 );
     
-    if( screen.supportsColors() )
+    initColors( screen );
+    
+    ::attron( COLOR_PAIR( 7 ) );
+    ::printw( "%s", info.c_str() );
+    ::attroff( COLOR_PAIR( 7 ) );
+}
+
+void printDashboard( const std::vector< Git::RepositoryStatus > & repositories, const UI::Screen & screen )
+{
+    size_t longestPath( 0 );
+    size_t longestBranch( 0 );
+    
+    if( screen.width() < 10 )
     {
-        ::init_pair( 1, COLOR_GREEN,   COLOR_BLACK );
-        ::init_pair( 2, COLOR_GREEN,   COLOR_BLACK );
-        ::init_pair( 3, COLOR_BLUE,    COLOR_BLACK );
-        ::init_pair( 4, COLOR_RED,     COLOR_BLACK );
-        ::init_pair( 5, COLOR_MAGENTA, COLOR_BLACK );
-        ::init_pair( 6, COLOR_YELLOW,  COLOR_BLACK );
-        ::init_pair( 7, COLOR_CYAN,    COLOR_BLACK );
-        ::init_pair( 8, COLOR_WHITE,   COLOR_BLACK );
+        return;
     }
     
-    if( branch == repos.head() )
+    for( const auto & repository: repositories )
     {
-        ::attron( COLOR_PAIR( 1 ) );
+        longestPath = std::max( longestPath, repository.path().length() );
         
-        symbol = "@";
+        if( repository.head().hasValue() )
+        {
+            longestBranch = std::max( longestBranch, repository.head()->name().length() );
+        }
     }
-    else
+    
+    initColors( screen );
+    
+    for( size_t i = 0; i < repositories.size() && i < screen.height(); i++ )
     {
-        if( repos.head()->isAhead( branch ) && repos.head()->isBehind( branch ) )
+        const Git::RepositoryStatus                               & repository( repositories[ i ] );
+        std::vector< std::pair< std::string, unsigned long long > > info;
+        std::string                                                 path( repository.path() );
+        std::string                                                 symbol;
+        unsigned long long                                          attr( 0 );
+        int                                                         x( 0 );
+        
+        if( repository.attention() == 4 )
         {
-            symbol = "%";
-            attr   = COLOR_PAIR( 5 );
+            symbol = "!";
+            attr   = COLOR_PAIR( 4 );
         }
-        else if( repos.head()->isAhead( branch ) )
+        else if( repository.attention() == 3 )
         {
-            symbol = ">";
-            attr   = COLOR_PAIR( 3 );
+            symbol = "%";
+            attr   = COLOR_PAIR( 5 );
         }
-        else if( repos.head()->isBehind( branch ) )
+        else if( repository.attention() == 2 )
         {
             symbol = "<";
             attr   = COLOR_PAIR( 4 );
         }
-        else if( branch.lastCommit().hasValue() && repos.head()->lastCommit().hasValue() && branch.lastCommit()->hash() == repos.head()->lastCommit()->hash() )
+        else if( repository.attention() == 1 )
+        {
+            symbol = ">";
+            attr   = COLOR_PAIR( 3 );
+        }
+        else if( repository.head().hasValue() && repository.head()->upstream().length() > 0 )
         {
             symbol = "=";
             attr   = COLOR_PAIR( 2 );
         }
         else
         {
-            symbol = "?";
-            attr   = COLOR_PAIR( 5 );
+            symbol = "-";
         }
-    }
-    
-    ::attron( attr );
-    
-    {
-        std::string info( symbol + " " + branch.name() );
         
-        if( info.length() > screen.width() )
+        path.resize( longestPath, ' ' );
+        
+        info.push_back( { symbol + " " + path, attr } );
+        
+        if( repository.error().length() > 0 )
         {
-            info = info.substr( 0, screen.width() );
+            info.push_back( { repository.error(), COLOR_PAIR( 4 ) } );
+        }
+        else if( repository.head().hasValue() )
+        {
+            const Git::BranchStatus & branch( *( repository.head() ) );
+            std::string               name( branch.name() );
+            
+            name.resize( longestBranch, ' ' );
+            
+            info.push_back( { name, COLOR_PAIR( 7 ) } );
+            
+            if( branch.upstream().length() > 0 )
+            {
+                info.push_back( { UI::BranchRow::upstreamInfo( branch ), attr } );
+            }
+            
+            if( branch.lastCommit().hasValue() )
+            {
+                info.push_back( { branch.lastCommit()->hash( 8 ), COLOR_PAIR( 6 ) } );
+                info.push_back( { branch.lastCommit()->summary(), COLOR_PAIR( 6 ) } );
+            }
         }
         
-        if( branch == repos.head() )
+        for( const auto & p: info )
         {
-            ::printw( "%s", info.c_str() );
+            std::string text( p.first );
+            
+            if( x >= static_cast< int >( screen.width() ) )
+            {
+                break;
+            }
+            
+            if( x + text.length() > screen.width() )
+            {
+                text = text.substr( 0, screen.width() - static_cast< size_t >( x ) );
+            }
+            
+            ::move( static_cast< int >( i ), x );
+            ::attron( p.second );
+            ::printw( "%s", text.c_str() );
+            ::attroff( p.second );
+            
+            x += static_cast< int >( text.length() ) + 1;
         }
-        else
+    }
+}
+
+std::vector< size_t > visibleSubmodules( const std::vector< Git::Submodule > & submodules, const std::set< std::string > & collapsed )
+{
+    std::vector< size_t > visible;
+    size_t                hidden( SIZE_MAX );
+    
+    /* Submodules are in tree order, so a collapsed one hides the deeper ones following it */
+    for( size_t i = 0; i < submodules.size(); i++ )
+    {
+        if( submodules[ i ].depth() > hidden )
+        {
+            continue;
+        }
+        
+        hidden = ( collapsed.count( submodules[ i ].path() ) > 0 ) ? submodules[ i ].depth() : SIZE_MAX;
+        
+        visible.push_back( i );
+    }
+    
+    return visible;
+}
+
+void printSubmodules( const std::vector< Git::Submodule > & submodules, const std::set< std::string > & collapsed, size_t selected, const UI::Screen & screen )
+{
+    std::vector< size_t > visible( visibleSubmodules( submodules, collapsed ) );
+    size_t                longestName( 0 );
+    size_t                longestBranch( 0 );
+    size_t                first( 0 );
+    
+    if( screen.width() < 10 || screen.height() == 0 )
+    {
+        return;
+    }
+    
+    /* Columns are sized for all submodules, so they don't move when the tree is collapsed */
+    for( const auto & submodule: submodules )
+    {
+        longestName = std::max( longestName, submodule.depth() * 2 + submodule.name().length() + 2 );
+        
+        if( submodule.status().hasValue() )
         {
-            ::printw( "  %s", info.c_str() );
+            longestBranch = std::max( longestBranch, submodule.status()->name().length() );
         }
     }
     
-    ::attroff( attr );
+    if( selected >= screen.height() )
+    {
+        first = selected - screen.height() + 1;
+    }
+    
+    initColors( screen );
     
+    for( size_t row = first; row < visible.size() && row - first < screen.height(); row++ )
     {
+        const Git::Submodule                                      & submodule( submodules[ visible[ row ] ] );
+        bool                                                        children( visible[ row ] + 1 < submodules.size() && submodules[ visible[ row ] + 1 ].depth() > submodule.depth() );
+        std::string                                                 tree( submodule.depth() * 2, ' ' );
         std::vector< std::pair< std::string, unsigned long long > > info;
-        size_t                                                      longestBranch( 0 );
-        size_t                                                      longestAuthor( 0 );
+        int                                                         x( 0 );
         
-        for( const auto & b: repos.branches() )
+        tree += ( children == false ) ? "  " : ( ( collapsed.count( submodule.path() ) > 0 ) ? "+ " : "- " );
+        tree += submodule.name();
+        tree.resize( longestName, ' ' );
+        
+        info.push_back( { tree, ( row == selected ) ? A_REVERSE : 0 } );
+        
+        if( submodule.status().hasValue() == false )
         {
-            if( b.name().size() > longestBranch )
-            {
-                longestBranch = b.name().size();
-            }
+            info.push_back( { "(not initialized)", COLOR_PAIR( 5 ) } );
+        }
+        else
+        {
+            const Git::BranchStatus & branch( *( submodule.status() ) );
+            std::string               name( branch.name() );
+            size_t                    ahead( 0 );
+            size_t                    behind( 0 );
+            unsigned long long        attr( 0 );
+            std::string               symbol( "-" );
             
-            if( b.lastCommit().hasValue() )
+            /* What matters is whether the checked out branch is behind its remote */
+            if( branch.upstreamAheadBehind( ahead, behind ) )
             {
+                if( ahead > 0 && behind > 0 )
                 {
-                    std::string author;
-                    
-                    if( b.lastCommit()->author().hasValue() )
-                    {
-                        author = b.lastCommit()->author()->name();
-                    }
-                    else if( b.lastCommit()->committer().hasValue() )
-                    {
-                        author = b.lastCommit()->committer()->name();
-                    }
-                    
-                    if( author.size() > longestAuthor )
-                    {
-                        longestAuthor = author.size();
-                    }
+                    symbol = "%";
+                    attr   = COLOR_PAIR( 5 );
                 }
+                else if( ahead > 0 )
+                {
+                    symbol = ">";
+                    attr   = COLOR_PAIR( 3 );
+                }
+                else if( behind > 0 )
+                {
+                    symbol = "<";
+                    attr   = COLOR_PAIR( 4 );
+                }
+                else
+                {
+                    symbol = "=";
+                    attr   = COLOR_PAIR( 2 );
+                }
+            }
+            
+            name.resize( longestBranch, ' ' );
+            
+            info.push_back( { symbol + " " + name, attr } );
+            
+            if( branch.upstream().length() > 0 )
+            {
+                info.push_back( { UI::BranchRow::upstreamInfo( branch ), attr } );
+            }
+            
+            if( branch.lastCommit().hasValue() )
+            {
+                info.push_back( { branch.lastCommit()->hash( 8 ), COLOR_PAIR( 6 ) } );
+                info.push_back( { branch.lastCommit()->summary(), COLOR_PAIR( 6 ) } );
             }
         }
         
-        longestBranch += 4;
-        
-        if( branch.lastCommit().hasValue() )
+        for( const auto & p: info )
         {
-            info.push_back( { branch.lastCommit()->hash( 8 ), COLOR_PAIR( 6 ) } );
+            std::string text( p.first );
             
-            if( branch.lastCommit()->time() > 0 )
+            if( x >= static_cast< int >( screen.width() ) )
             {
-                {
-                    std::tm           tm;
-                    std::stringstream ss;
-                    time_t            t( branch.lastCommit()->time() );
-                    
-                    memset( &tm, 0, sizeof( std::tm ) );
-                    localtime_r( &t, &tm );
-                    
-                    ss << std::put_time( &tm, "%x %X" );
-                    
-                    if( ss.str().length() > 0 )
-                    {
-                        info.push_back( { ss.str(), COLOR_PAIR( 7 ) } );
-                    }
-                }
+                break;
             }
             
+            if( x + text.length() > screen.width() )
             {
-                std::stringstream ss;
-                
-                ss << std::setw( static_cast< int >( longestAuthor ) );
-                
-                if( branch.lastCommit()->author().hasValue() )
-                {
-                    ss << branch.lastCommit()->author()->name();
-                }
-                else if( branch.lastCommit()->committer().hasValue() )
-                {
-                    ss << branch.lastCommit()->committer()->name();
-                }
-                
-                info.push_back( { ss.str(), COLOR_PAIR( 8 ) } );
+                text = text.substr( 0, screen.width() - static_cast< size_t >( x ) );
             }
             
+            ::move( static_cast< int >( row - first ), x );
+            ::attron( p.second );
+            ::printw( "%s", text.c_str() );
+            ::attroff( p.second );
+            
+            x += static_cast< int >( text.length() ) + 1;
+        }
+    }
+}
+
+void printMatrix( const Git::Repository & repos, const std::vector< std::string > & names, const UI::Screen & screen )
+{
+    std::vector< Git::Branch >                                branches;
+    std::vector< std::vector< std::pair< size_t, size_t > > > matrix;
+    size_t                                                    digits( 1 );
+    size_t                                                    longestBranch( 0 );
+    
+    for( const auto & branch: repos.branches() )
+    {
+        if( names.size() == 0 || std::find( names.begin(), names.end(), branch.name() ) != names.end() )
+        {
+            branches.push_back( branch );
+        }
+    }
+    
+    matrix = repos.matrix( branches );
+    
+    for( size_t n = branches.size(); n >= 10; n /= 10 )
+    {
+        digits++;
+    }
+    
+    for( const auto & branch: branches )
+    {
+        longestBranch = std::max( longestBranch, branch.name().size() );
+    }
+    
+    initColors( screen );
+    
+    /*
+     * Columns are numbered like rows, with the digits printed vertically.
+     * Each cell compares the row's branch with the column's branch, the
+     * same way a branch is compared with HEAD.
+     */
+    {
+        int x( static_cast< int >( digits + longestBranch + 2 ) );
+        
+        for( size_t d = 0; d < digits && d < screen.height(); d++ )
+        {
+            for( size_t i = 0; i < branches.size() && x + static_cast< int >( i * 2 ) < static_cast< int >( screen.width() ); i++ )
             {
-                std::string message( branch.lastCommit()->message() );
+                std::string number( std::to_string( i + 1 ) );
                 
-                if( message.find( "\n" ) != std::string::npos )
-                {
-                    message = message.substr( 0, message.find( "\n" ) );
-                }
+                number.insert( 0, digits - number.size(), ' ' );
                 
-                info.push_back( { message, COLOR_PAIR( 6 ) } );
+                ::move( static_cast< int >( d ), x + static_cast< int >( i * 2 ) );
+                ::printw( "%c", number[ d ] );
             }
         }
+    }
+    
+    for( size_t i = 0; i < branches.size() && digits + i < screen.height(); i++ )
+    {
+        int         y( static_cast< int >( digits + i ) );
+        std::string number( std::to_string( i + 1 ) );
+        
+        number.insert( 0, digits - number.size(), ' ' );
         
+        ::move( y, 0 );
+        ::printw( "%s %s", number.c_str(), branches[ i ].name().c_str() );
+        
+        for( size_t j = 0; j < branches.size(); j++ )
         {
-            int x( static_cast< int >( longestBranch ) );
+            int                x( static_cast< int >( digits + longestBranch + 2 + j * 2 ) );
+            std::string        symbol;
+            unsigned long long attr( 0 );
             
-            for( const auto & p: info )
+            if( x + 1 >= static_cast< int >( screen.width() ) )
             {
-                if( x + p.first.length() >= screen.width() )
-                {
-                    break;
-                }
-                
-                ::move( y, x );
-                ::attron( p.second );
-                ::printw( " %s", p.first.c_str() );
-                ::attroff( p.second );
-                
-                x += p.first.length() + 1;
+                break;
+            }
+            
+            if( i == j )
+            {
+                symbol = "-";
+            }
+            else if( matrix[ i ][ j ].first > 0 && matrix[ i ][ j ].second > 0 )
+            {
+                symbol = "%";
+                attr   = COLOR_PAIR( 5 );
+            }
+            else if( matrix[ i ][ j ].first > 0 )
+            {
+                symbol = ">";
+                attr   = COLOR_PAIR( 3 );
+            }
+            else if( matrix[ i ][ j ].second > 0 )
+            {
+                symbol = "<";
+                attr   = COLOR_PAIR( 4 );
             }
+            else
+            {
+                symbol = "=";
+                attr   = COLOR_PAIR( 2 );
+            }
+            
+            ::move( y, x );
+            ::attron( attr );
+            ::printw( "%s", symbol.c_str() );
+            ::attroff( attr );
         }
     }
-    
-    ::attroff( COLOR_PAIR( 1 ) );
-    ::attroff( COLOR_PAIR( 2 ) );
-    ::attroff( COLOR_PAIR( 3 ) );
-    ::attroff( COLOR_PAIR( 4 ) );
-    ::attroff( COLOR_PAIR( 5 ) );
 }
 
 static void showHelp( void )
 {
-    std::cout << "Usage: git-branch-status [OPTIONS] [PATH]"
+    std::cout << "Usage: git-branch-status [OPTIONS] [PATH...]"
               << std::endl
               << std::endl
               << "Options:"
@@ -350,5 +777,34 @@ static void showHelp( void )
               << "    --fetch-origin     Automatically fetches changes from origin"
               << std::endl
               << "    --keychain-item    The name of a keychain item containing Git credentials"
+              << std::endl
+              << "    --max-walk         Maximum number of commits walked per ahead/behind count"
+              << std::endl
+              << "    --max-time         Maximum time in milliseconds spent per ahead/behind count"
+              << std::endl
+              << "    --upstream         Compares branches with their upstream instead of HEAD"
+              << std::endl
+              << "    --matrix           Shows which branches are merged into which"
+              << std::endl
+              << "    --matrix-branches  Comma-separated list of branches to show in the matrix"
+              << std::endl
+              << "    --include          Only shows branches matching a glob pattern (repeatable)"
+              << std::endl
+              << "    --exclude          Hides branches matching a glob pattern (repeatable)"
+              << std::endl
+              << "    --worktrees        Shows the HEAD of each worktree of the repository"
+              << std::endl
+              << "    --submodules       Shows the checked out branch of each submodule, as a tree (space collapses)"
+              << std::endl
+              << "    --path-list        A file listing repositories to monitor, one per line"
+              << std::endl
+              << "    --discover         Monitors every repository found below a directory (repeatable)"
+              << std::endl
+              << "    --ignore           Skips directories matching a glob pattern while discovering (repeatable)"
+              << std::endl
+              << std::endl
+              << "With several repositories, a summary of each one is shown, the ones needing"
+              << std::endl
+              << "attention first."
               << std::endl;
 }